@@ -114,6 +114,7 @@ int bubblemaker_init(void)
 		LOG_ERR("Failed to create bubblemaker thread");
 		return -1;
 	}
+	k_thread_name_set(&bubblemaker_thread, "bubblemaker");
 
 	return 0;
 }
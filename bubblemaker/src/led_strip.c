@@ -189,6 +189,7 @@ int led_strip_init(void)
 		LOG_ERR("Failed to create led_strip thread");
 		return -1;
 	}
+	k_thread_name_set(&led_strip_thread, "led_strip");
 
 	return 0;
 }
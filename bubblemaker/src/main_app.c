@@ -27,6 +27,7 @@
 #include <anjay_zephyr/objects.h>
 
 #include "peripherals.h"
+#include "runtime_metrics.h"
 #include "status_led.h"
 #include "sensors.h"
 #include "bubblemaker.h"
@@ -44,6 +45,9 @@ static const anjay_dm_object_def_t **led_color_light_obj;
 #if SWITCH_AVAILABLE_ANY
 static const anjay_dm_object_def_t **switch_obj;
 #endif // SWITCH_AVAILABLE_ANY
+#ifdef CONFIG_APP_RUNTIME_METRICS
+static const anjay_dm_object_def_t **runtime_metrics_obj;
+#endif // CONFIG_APP_RUNTIME_METRICS
 static avs_sched_handle_t update_objects_handle;
 
 #if PUSH_BUTTON_AVAILABLE_ANY
@@ -112,6 +116,13 @@ static int register_objects(anjay_t *anjay)
 		anjay_register_object(anjay, switch_obj);
 	}
 #endif // SWITCH_AVAILABLE_ANY
+
+#ifdef CONFIG_APP_RUNTIME_METRICS
+	runtime_metrics_obj = runtime_metrics_object_create();
+	if (runtime_metrics_obj) {
+		anjay_register_object(anjay, runtime_metrics_obj);
+	}
+#endif // CONFIG_APP_RUNTIME_METRICS
 	return 0;
 }
 
@@ -129,8 +140,6 @@ static void update_objects(avs_sched_t *sched, const void *anjay_ptr)
 
 	update_objects_frequent(anjay);
 
-	status_led_toggle();
-
 	AVS_SCHED_DELAYED(sched, &update_objects_handle,
 			  avs_time_duration_from_scalar(1, AVS_TIME_S), update_objects, &anjay,
 			  sizeof(anjay));
@@ -142,7 +151,7 @@ static int init_update_objects(anjay_t *anjay)
 
 	update_objects(sched, &anjay);
 
-	status_led_init();
+	status_led_set_pattern(STATUS_LED_PATTERN_HEARTBEAT);
 
 	return 0;
 }
@@ -150,6 +159,7 @@ static int init_update_objects(anjay_t *anjay)
 static int clean_before_anjay_destroy(anjay_t *anjay)
 {
 	avs_sched_del(&update_objects_handle);
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
 
 	return 0;
 }
@@ -166,6 +176,9 @@ static int release_objects(void)
 #if LED_COLOR_LIGHT_AVAILABLE
 	anjay_zephyr_led_color_light_object_release(&led_color_light_obj);
 #endif // LED_COLOR_LIGHT_AVAILABLE
+#ifdef CONFIG_APP_RUNTIME_METRICS
+	runtime_metrics_object_release(runtime_metrics_obj);
+#endif // CONFIG_APP_RUNTIME_METRICS
 
 	return 0;
 }
@@ -190,6 +203,9 @@ int main(void)
 {
 	LOG_INF("Initializing Anjay-zephyr-client Bubblemaker " CONFIG_ANJAY_ZEPHYR_VERSION);
 
+	status_led_init();
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
+
 	anjay_zephyr_lwm2m_set_user_callback(lwm2m_callback);
 	anjay_zephyr_lwm2m_init_from_settings();
 	anjay_zephyr_lwm2m_start();
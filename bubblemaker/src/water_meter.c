@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/drivers/gpio.h>
@@ -70,12 +72,23 @@ struct water_meter_instance {
 	double max_flow;
 };
 
+#define WATER_METER_COUNT (WATER_METER_0_AVAILABLE + WATER_METER_1_AVAILABLE)
+
 struct water_meter_object {
 	const anjay_dm_object_def_t *def;
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	// indexed by Instance ID
+	struct water_meter_instance instances[WATER_METER_COUNT];
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct water_meter_instance) instances;
+#endif // CONFIG_APP_STATIC_OBJECTS
 };
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+static struct water_meter_object object_storage;
+#endif // CONFIG_APP_STATIC_OBJECTS
+
 #if WATER_METER_0_AVAILABLE
 struct water_meter_instance *wm_inst_0_ptr;
 atomic_t water_meter_0_irq_count = ATOMIC_INIT(0);
@@ -139,6 +152,9 @@ static inline struct water_meter_object *get_obj(const anjay_dm_object_def_t *co
 static struct water_meter_instance *find_instance(const struct water_meter_object *obj,
 						  anjay_iid_t iid)
 {
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	return iid < WATER_METER_COUNT ? (struct water_meter_instance *)&obj->instances[iid] : NULL;
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct water_meter_instance) it;
 	AVS_LIST_FOREACH(it, obj->instances)
 	{
@@ -150,6 +166,7 @@ static struct water_meter_instance *find_instance(const struct water_meter_objec
 	}
 
 	return NULL;
+#endif // CONFIG_APP_STATIC_OBJECTS
 }
 
 static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
@@ -157,11 +174,19 @@ static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *ob
 {
 	(void)anjay;
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	(void)obj_ptr;
+
+	for (anjay_iid_t iid = 0; iid < WATER_METER_COUNT; iid++) {
+		anjay_dm_emit(ctx, iid);
+	}
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct water_meter_instance) it;
 	AVS_LIST_FOREACH(it, get_obj(obj_ptr)->instances)
 	{
 		anjay_dm_emit(ctx, it->iid);
 	}
+#endif // CONFIG_APP_STATIC_OBJECTS
 
 	return 0;
 }
@@ -186,6 +211,16 @@ static void release_instance(struct water_meter_instance *inst)
 	(void)inst;
 }
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+static struct water_meter_instance *add_instance(struct water_meter_object *obj, anjay_iid_t iid)
+{
+	assert(iid < WATER_METER_COUNT);
+
+	struct water_meter_instance *created = &obj->instances[iid];
+
+	return init_instance(created, iid) ? NULL : created;
+}
+#else  // CONFIG_APP_STATIC_OBJECTS
 static struct water_meter_instance *add_instance(struct water_meter_object *obj, anjay_iid_t iid)
 {
 	assert(find_instance(obj, iid) == NULL);
@@ -215,6 +250,26 @@ static struct water_meter_instance *add_instance(struct water_meter_object *obj,
 	AVS_LIST_INSERT(ptr, created);
 	return created;
 }
+#endif // CONFIG_APP_STATIC_OBJECTS
+
+static struct water_meter_object *alloc_object(void)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	memset(&object_storage, 0, sizeof(object_storage));
+	return &object_storage;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	return (struct water_meter_object *)avs_calloc(1, sizeof(struct water_meter_object));
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
+
+static void free_object(struct water_meter_object *obj)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	(void)obj;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	avs_free(obj);
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
 
 static int instance_reset(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
 			  anjay_iid_t iid)
@@ -319,20 +374,20 @@ static const anjay_dm_object_def_t OBJ_DEF = { .oid = 3424,
 
 const anjay_dm_object_def_t **water_meter_object_create(void)
 {
-	struct water_meter_object *obj =
-		(struct water_meter_object *)avs_calloc(1, sizeof(struct water_meter_object));
+	struct water_meter_object *obj = alloc_object();
+
 	if (!obj) {
 		return NULL;
 	}
 	obj->def = &OBJ_DEF;
 
-	static int instance_counter;
+	anjay_iid_t instance_counter = 0;
 
 #if WATER_METER_0_AVAILABLE
 	wm_inst_0_ptr = add_instance(obj, instance_counter++);
 
 	if (!wm_inst_0_ptr) {
-		avs_free(obj);
+		free_object(obj);
 		return NULL;
 	}
 #endif // WATER_METER_0_AVAILABLE
@@ -341,7 +396,7 @@ const anjay_dm_object_def_t **water_meter_object_create(void)
 	wm_inst_1_ptr = add_instance(obj, instance_counter++);
 
 	if (!wm_inst_1_ptr) {
-		avs_free(obj);
+		free_object(obj);
 		return NULL;
 	}
 #endif // WATER_METER_1_AVAILABLE
@@ -354,11 +409,17 @@ void water_meter_object_release(const anjay_dm_object_def_t **def)
 	if (def) {
 		struct water_meter_object *obj = get_obj(def);
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+		for (size_t i = 0; i < WATER_METER_COUNT; i++) {
+			release_instance(&obj->instances[i]);
+		}
+#else  // CONFIG_APP_STATIC_OBJECTS
 		AVS_LIST_CLEAR(&obj->instances)
 		{
 			release_instance(obj->instances);
 		}
-		avs_free(obj);
+#endif // CONFIG_APP_STATIC_OBJECTS
+		free_object(obj);
 	}
 }
 
@@ -462,6 +523,7 @@ int water_meter_init(void)
 		LOG_ERR("Failed to create water_meter thread");
 		return -1;
 	}
+	k_thread_name_set(&water_meter_thread, "water_meter");
 
 	return 0;
 }
@@ -88,12 +88,24 @@ struct power_control_instance {
 	bool state;
 };
 
+// all instances control the same pump, so only a few of them make sense
+#define POWER_CONTROL_MAX_INSTANCES 4
+
 struct power_control_object {
 	const anjay_dm_object_def_t *def;
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	// indexed by Instance ID, free slots have iid set to ANJAY_ID_INVALID
+	struct power_control_instance instances[POWER_CONTROL_MAX_INSTANCES];
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct power_control_instance) instances;
+#endif // CONFIG_APP_STATIC_OBJECTS
 };
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+static struct power_control_object object_storage;
+#endif // CONFIG_APP_STATIC_OBJECTS
+
 static inline struct power_control_object *get_obj(const anjay_dm_object_def_t *const *obj_ptr)
 {
 	assert(obj_ptr);
@@ -103,6 +115,12 @@ static inline struct power_control_object *get_obj(const anjay_dm_object_def_t *
 static struct power_control_instance *find_instance(const struct power_control_object *obj,
 						    anjay_iid_t iid)
 {
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	if (iid >= POWER_CONTROL_MAX_INSTANCES || obj->instances[iid].iid != iid) {
+		return NULL;
+	}
+	return (struct power_control_instance *)&obj->instances[iid];
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct power_control_instance) it;
 	AVS_LIST_FOREACH(it, obj->instances)
 	{
@@ -114,6 +132,7 @@ static struct power_control_instance *find_instance(const struct power_control_o
 	}
 
 	return NULL;
+#endif // CONFIG_APP_STATIC_OBJECTS
 }
 
 static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
@@ -121,11 +140,21 @@ static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *ob
 {
 	(void)anjay;
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	struct power_control_object *obj = get_obj(obj_ptr);
+
+	for (anjay_iid_t iid = 0; iid < POWER_CONTROL_MAX_INSTANCES; iid++) {
+		if (obj->instances[iid].iid == iid) {
+			anjay_dm_emit(ctx, iid);
+		}
+	}
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct power_control_instance) it;
 	AVS_LIST_FOREACH(it, get_obj(obj_ptr)->instances)
 	{
 		anjay_dm_emit(ctx, it->iid);
 	}
+#endif // CONFIG_APP_STATIC_OBJECTS
 
 	return 0;
 }
@@ -149,6 +178,21 @@ static void release_instance(struct power_control_instance *inst)
 	(void)inst;
 }
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+static struct power_control_instance *add_instance(struct power_control_object *obj,
+						   anjay_iid_t iid)
+{
+	assert(find_instance(obj, iid) == NULL);
+
+	if (iid >= POWER_CONTROL_MAX_INSTANCES) {
+		return NULL;
+	}
+
+	struct power_control_instance *created = &obj->instances[iid];
+
+	return init_instance(created, iid) ? NULL : created;
+}
+#else  // CONFIG_APP_STATIC_OBJECTS
 static struct power_control_instance *add_instance(struct power_control_object *obj,
 						   anjay_iid_t iid)
 {
@@ -178,6 +222,28 @@ static struct power_control_instance *add_instance(struct power_control_object *
 	AVS_LIST_INSERT(ptr, created);
 	return created;
 }
+#endif // CONFIG_APP_STATIC_OBJECTS
+
+static struct power_control_object *alloc_object(void)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	for (size_t i = 0; i < POWER_CONTROL_MAX_INSTANCES; i++) {
+		object_storage.instances[i].iid = ANJAY_ID_INVALID;
+	}
+	return &object_storage;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	return (struct power_control_object *)avs_calloc(1, sizeof(struct power_control_object));
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
+
+static void free_object(struct power_control_object *obj)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	(void)obj;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	avs_free(obj);
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
 
 static int instance_create(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
 			   anjay_iid_t iid)
@@ -194,6 +260,15 @@ static int instance_remove(anjay_t *anjay, const anjay_dm_object_def_t *const *o
 	(void)anjay;
 	struct power_control_object *obj = get_obj(obj_ptr);
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	struct power_control_instance *inst = find_instance(obj, iid);
+
+	if (inst) {
+		release_instance(inst);
+		inst->iid = ANJAY_ID_INVALID;
+		return 0;
+	}
+#else  // CONFIG_APP_STATIC_OBJECTS
 	AVS_LIST(struct power_control_instance) * it;
 	AVS_LIST_FOREACH_PTR(it, &obj->instances)
 	{
@@ -205,6 +280,7 @@ static int instance_remove(anjay_t *anjay, const anjay_dm_object_def_t *const *o
 			break;
 		}
 	}
+#endif // CONFIG_APP_STATIC_OBJECTS
 
 	assert(0);
 	return ANJAY_ERR_NOT_FOUND;
@@ -323,15 +399,15 @@ static const anjay_dm_object_def_t OBJ_DEF = {
 
 const anjay_dm_object_def_t **power_control_object_create(void)
 {
-	struct power_control_object *obj =
-		(struct power_control_object *)avs_calloc(1, sizeof(struct power_control_object));
+	struct power_control_object *obj = alloc_object();
+
 	if (!obj) {
 		return NULL;
 	}
 	obj->def = &OBJ_DEF;
 
 	if (!add_instance(obj, 0)) {
-		avs_free(obj);
+		free_object(obj);
 		return NULL;
 	}
 
@@ -343,11 +419,19 @@ void power_control_object_release(const anjay_dm_object_def_t **def)
 	if (def) {
 		struct power_control_object *obj = get_obj(def);
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+		for (anjay_iid_t iid = 0; iid < POWER_CONTROL_MAX_INSTANCES; iid++) {
+			if (obj->instances[iid].iid == iid) {
+				release_instance(&obj->instances[iid]);
+			}
+		}
+#else  // CONFIG_APP_STATIC_OBJECTS
 		AVS_LIST_CLEAR(&obj->instances)
 		{
 			release_instance(obj->instances);
 		}
-		avs_free(obj);
+#endif // CONFIG_APP_STATIC_OBJECTS
+		free_object(obj);
 	}
 }
 
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include "benchmark.h"
+#include "orientation.h"
+
+#ifdef CONFIG_BOARD_NATIVE_SIM
+#include <posix_board_if.h>
+
+#include "native_sim/benchmark_host.h"
+#endif // CONFIG_BOARD_NATIVE_SIM
+
+#if CONFIG_APP_BENCHMARK_I2C_LATENCY_US > 0 || CONFIG_APP_BENCHMARK_I2C_NACK_EVERY > 0
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
+
+#define BENCHMARK_I2C_FAULTS
+#endif // CONFIG_APP_BENCHMARK_I2C_LATENCY_US > 0 || CONFIG_APP_BENCHMARK_I2C_NACK_EVERY > 0
+
+LOG_MODULE_REGISTER(benchmark);
+
+static uint32_t cycles_count;
+static uint64_t cycle_start;
+static uint64_t total_ns;
+static uint64_t max_ns;
+static uint32_t cycle_start_cyc;
+static uint64_t wall_total_ns;
+static uint64_t wall_max_ns;
+
+// updated by the sensor hub thread
+static uint32_t hub_batches_count;
+static uint64_t hub_batch_start;
+static uint64_t hub_total_ns;
+static uint64_t hub_max_ns;
+
+/**
+ * On native_sim the simulated clock does not advance while code is running, so
+ * the CPU time of the host thread is used instead of the cycle counter.
+ */
+static uint64_t timestamp(void)
+{
+#ifdef CONFIG_BOARD_NATIVE_SIM
+	return benchmark_host_thread_cpu_time_ns();
+#else  // CONFIG_BOARD_NATIVE_SIM
+	return k_cycle_get_32();
+#endif // CONFIG_BOARD_NATIVE_SIM
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+#ifdef CONFIG_BOARD_NATIVE_SIM
+	return timestamp() - start;
+#else  // CONFIG_BOARD_NATIVE_SIM
+	return k_cyc_to_ns_floor64((uint32_t)(timestamp() - start));
+#endif // CONFIG_BOARD_NATIVE_SIM
+}
+
+/**
+ * Wall-clock time, in which the Anjay thread may also be blocked, e.g. waiting
+ * for a bus transfer. On native_sim, it is the simulated time, which only
+ * advances while all threads wait, so it shows exactly the time spent blocked.
+ */
+static uint64_t wall_elapsed_ns(uint32_t start_cyc)
+{
+	return k_cyc_to_ns_floor64(k_cycle_get_32() - start_cyc);
+}
+
+#ifdef BENCHMARK_I2C_FAULTS
+static atomic_t i2c_transfers_count;
+
+/**
+ * Models a slow or unreliable bus in front of the emulated I2C targets: every
+ * transfer blocks the calling thread for CONFIG_APP_BENCHMARK_I2C_LATENCY_US,
+ * as an interrupt-driven controller driver would, and every
+ * CONFIG_APP_BENCHMARK_I2C_NACK_EVERY-th one then fails as if not acknowledged.
+ */
+static int slow_i2c_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+			     int addr)
+{
+	(void)target;
+	(void)msgs;
+	(void)num_msgs;
+	(void)addr;
+
+	atomic_val_t index = atomic_inc(&i2c_transfers_count);
+
+#if CONFIG_APP_BENCHMARK_I2C_LATENCY_US > 0
+	k_sleep(K_USEC(CONFIG_APP_BENCHMARK_I2C_LATENCY_US));
+#endif // CONFIG_APP_BENCHMARK_I2C_LATENCY_US > 0
+#if CONFIG_APP_BENCHMARK_I2C_NACK_EVERY > 0
+	if ((index + 1) % CONFIG_APP_BENCHMARK_I2C_NACK_EVERY == 0) {
+		return -EIO;
+	}
+#else  // CONFIG_APP_BENCHMARK_I2C_NACK_EVERY > 0
+	(void)index;
+#endif // CONFIG_APP_BENCHMARK_I2C_NACK_EVERY > 0
+	// let the target emulator handle the transfer
+	return -ENOSYS;
+}
+
+static struct i2c_emul_api slow_i2c_api = {
+	.transfer = slow_i2c_transfer,
+};
+
+#define SLOW_I2C_EMUL_GET(node_id) EMUL_DT_GET(node_id),
+
+static int slow_i2c_init(void)
+{
+	static const struct emul *const targets[] = { DT_FOREACH_CHILD_STATUS_OKAY(
+		DT_NODELABEL(i2c0), SLOW_I2C_EMUL_GET) };
+
+	for (size_t i = 0; i < ARRAY_SIZE(targets); i++) {
+		targets[i]->bus.i2c->mock_api = &slow_i2c_api;
+	}
+	return 0;
+}
+
+SYS_INIT(slow_i2c_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif // BENCHMARK_I2C_FAULTS
+
+static void report_heap(void)
+{
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	struct sys_memory_stats stats;
+
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0
+	extern struct k_heap _system_heap;
+
+	if (!sys_heap_runtime_stats_get(&_system_heap.heap, &stats)) {
+		LOG_INF("k_malloc heap: peak %zu B of %zu B", stats.max_allocated_bytes,
+			stats.allocated_bytes + stats.free_bytes);
+	}
+#endif // CONFIG_HEAP_MEM_POOL_SIZE > 0
+#ifdef CONFIG_COMMON_LIBC_MALLOC
+	if (!malloc_runtime_stats_get(&stats)) {
+		LOG_INF("malloc arena: peak %zu B of %zu B", stats.max_allocated_bytes,
+			stats.allocated_bytes + stats.free_bytes);
+	}
+#endif // CONFIG_COMMON_LIBC_MALLOC
+#endif // CONFIG_SYS_HEAP_RUNTIME_STATS
+}
+
+static void report_thread_stack(const struct k_thread *thread, void *user_data)
+{
+	(void)user_data;
+
+	size_t unused;
+
+	if (k_thread_stack_space_get(thread, &unused)) {
+		return;
+	}
+
+	LOG_INF("Stack of %s: %zu B used of %zu B", k_thread_name_get((k_tid_t)thread),
+		thread->stack_info.size - unused, thread->stack_info.size);
+}
+
+#ifdef CONFIG_APP_ORIENTATION
+#define REPLAY_STEPS 3000
+#define REPLAY_DT_S 0.02f
+#define REPLAY_YAW_RATE (30.0f * (float)M_PI / 180.0f)
+#define REPLAY_ROLL (20.0f * (float)M_PI / 180.0f)
+#define REPLAY_GYRO_BIAS 0.01f
+// steps before the filter is considered settled
+#define REPLAY_SETTLE_STEPS 100
+
+// world vector expressed in the sensor frame rotated by yaw about down, then by roll about x
+static void replay_to_sensor_frame(float yaw, const float *world, float *out)
+{
+	float x = cosf(yaw) * world[0] + sinf(yaw) * world[1];
+	float y = -sinf(yaw) * world[0] + cosf(yaw) * world[1];
+
+	out[0] = x;
+	out[1] = cosf(REPLAY_ROLL) * y + sinf(REPLAY_ROLL) * world[2];
+	out[2] = -sinf(REPLAY_ROLL) * y + cosf(REPLAY_ROLL) * world[2];
+}
+
+/**
+ * Replays a synthetic recording of the device spinning at a constant rate,
+ * tilted, with a biased gyrometer, and compares the heading with the truth.
+ */
+static void report_orientation(void)
+{
+	// the accelerometer measures "up" in the North-East-Down frame
+	static const float accel_world[3] = { 0.0f, 0.0f, -9.81f };
+	static const float magn_world[3] = { 20e-6f, 0.0f, 45e-6f };
+	const float gyro[3] = { 0.0f, sinf(REPLAY_ROLL) * REPLAY_YAW_RATE + REPLAY_GYRO_BIAS,
+				cosf(REPLAY_ROLL) * REPLAY_YAW_RATE + REPLAY_GYRO_BIAS };
+	struct orientation_filter filter;
+	uint64_t total_step_ns = 0;
+	float total_error = 0.0f;
+	float max_error = 0.0f;
+
+	orientation_filter_reset(&filter);
+	for (int i = 0; i < REPLAY_STEPS; i++) {
+		float yaw = REPLAY_YAW_RATE * REPLAY_DT_S * i;
+		float accel[3];
+		float magn[3];
+
+		replay_to_sensor_frame(yaw, accel_world, accel);
+		replay_to_sensor_frame(yaw, magn_world, magn);
+
+		uint64_t start = timestamp();
+
+		orientation_filter_update(&filter, gyro, accel, magn, REPLAY_DT_S);
+		total_step_ns += elapsed_ns(start);
+
+		float error = fabsf(orientation_filter_heading(&filter) -
+				    fmodf(yaw * 180.0f / (float)M_PI, 360.0f));
+
+		error = MIN(error, 360.0f - error);
+		if (i >= REPLAY_SETTLE_STEPS) {
+			total_error += error;
+			max_error = MAX(max_error, error);
+		}
+	}
+
+	LOG_INF("Orientation replay: heading error mean %d mdeg, max %d mdeg, %llu ns per step",
+		(int)(1000.0f * total_error / (REPLAY_STEPS - REPLAY_SETTLE_STEPS)),
+		(int)(1000.0f * max_error), total_step_ns / REPLAY_STEPS);
+}
+#endif // CONFIG_APP_ORIENTATION
+
+#define LOG_CALLS 100
+
+/**
+ * Measures the cost of a typical log call, to compare the logging profiles,
+ * e.g. text and dictionary output. In the panic mode, the messages are output
+ * synchronously, so the cost includes the output by the backends.
+ */
+static void report_log_calls(void)
+{
+	uint64_t start = timestamp();
+
+	for (int i = 0; i < LOG_CALLS; i++) {
+		LOG_INF("Log call %d of %d: %s", i + 1, LOG_CALLS, "benchmark");
+	}
+
+	LOG_INF("Log call: %llu ns", elapsed_ns(start) / LOG_CALLS);
+}
+
+static void report(void)
+{
+	LOG_INF("Benchmark finished after %u update cycles", cycles_count);
+	LOG_INF("CPU time per cycle: mean %llu ns, max %llu ns", total_ns / cycles_count,
+		max_ns);
+	LOG_INF("Wall-clock time per cycle: mean %llu ns, max %llu ns",
+		wall_total_ns / cycles_count, wall_max_ns);
+#ifdef BENCHMARK_I2C_FAULTS
+	LOG_INF("Emulated I2C: %u transfers, %d us latency, NACK every %d",
+		(unsigned int)atomic_get(&i2c_transfers_count), CONFIG_APP_BENCHMARK_I2C_LATENCY_US,
+		CONFIG_APP_BENCHMARK_I2C_NACK_EVERY);
+#endif // BENCHMARK_I2C_FAULTS
+	if (hub_batches_count) {
+		LOG_INF("CPU time per sensor hub batch: mean %llu ns, max %llu ns (%u batches)",
+			hub_total_ns / hub_batches_count, hub_max_ns, hub_batches_count);
+	}
+	report_heap();
+#ifdef CONFIG_APP_ORIENTATION
+	report_orientation();
+#endif // CONFIG_APP_ORIENTATION
+	k_thread_foreach_unlocked(report_thread_stack, NULL);
+
+#ifdef CONFIG_BOARD_NATIVE_SIM
+	// flushes the messages above, the following ones are output synchronously
+	LOG_PANIC();
+	report_log_calls();
+	posix_exit(0);
+#else  // CONFIG_BOARD_NATIVE_SIM
+	// the device keeps running, so deferred logging is left as it is
+	report_log_calls();
+#endif // CONFIG_BOARD_NATIVE_SIM
+}
+
+void benchmark_cycle_begin(void)
+{
+	cycle_start = timestamp();
+	cycle_start_cyc = k_cycle_get_32();
+}
+
+void benchmark_cycle_end(void)
+{
+	if (cycles_count >= CONFIG_APP_BENCHMARK_CYCLES) {
+		return;
+	}
+
+	uint64_t duration_ns = elapsed_ns(cycle_start);
+	uint64_t wall_duration_ns = wall_elapsed_ns(cycle_start_cyc);
+
+	total_ns += duration_ns;
+	max_ns = MAX(max_ns, duration_ns);
+	wall_total_ns += wall_duration_ns;
+	wall_max_ns = MAX(wall_max_ns, wall_duration_ns);
+
+	if (++cycles_count == CONFIG_APP_BENCHMARK_CYCLES) {
+		report();
+	}
+}
+
+void benchmark_hub_batch_begin(void)
+{
+	hub_batch_start = timestamp();
+}
+
+void benchmark_hub_batch_end(void)
+{
+	uint64_t duration_ns = elapsed_ns(hub_batch_start);
+
+	hub_total_ns += duration_ns;
+	hub_max_ns = MAX(hub_max_ns, duration_ns);
+	hub_batches_count++;
+}
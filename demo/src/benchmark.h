@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifdef CONFIG_APP_BENCHMARK
+
+/**
+ * Called around every wakeup of the update scheduler. After
+ * CONFIG_APP_BENCHMARK_CYCLES wakeups, CPU and wall-clock time per cycle, peak
+ * heap usage and thread stack high-water marks are logged, and the native_sim
+ * executable exits.
+ */
+void benchmark_cycle_begin(void);
+void benchmark_cycle_end(void);
+
+/**
+ * Called around every batch of fetches of the sensor hub thread, whose CPU time
+ * is reported along with that of the update cycles.
+ */
+void benchmark_hub_batch_begin(void);
+void benchmark_hub_batch_end(void);
+
+#else // CONFIG_APP_BENCHMARK
+
+#define benchmark_cycle_begin() ((void)0)
+#define benchmark_cycle_end() ((void)0)
+#define benchmark_hub_batch_begin() ((void)0)
+#define benchmark_hub_batch_end() ((void)0)
+
+#endif // CONFIG_APP_BENCHMARK
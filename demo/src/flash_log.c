@@ -0,0 +1,415 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#include <avsystem/commons/avs_defs.h>
+
+#include "flash_log.h"
+
+LOG_MODULE_REGISTER(flash_log);
+
+#ifdef CONFIG_PARTITION_MANAGER_ENABLED
+#include <pm_config.h>
+#define FLASH_LOG_AREA_ID PM_SAMPLE_LOG_ID
+#else  // CONFIG_PARTITION_MANAGER_ENABLED
+#define FLASH_LOG_AREA_ID FIXED_PARTITION_ID(sample_log_partition)
+#endif // CONFIG_PARTITION_MANAGER_ENABLED
+
+// "SLOG"
+#define BLOCK_MAGIC 0x534c4f47
+// "CONS"
+#define CONSUMED_MAGIC 0x434f4e53
+#define SEQ_NONE 0
+
+struct block_header {
+	uint32_t magic;
+	// increasing with each opened block, determines the order of blocks
+	uint32_t seq;
+};
+
+struct flash_record {
+	int64_t timestamp_ms;
+	double value;
+	uint16_t oid;
+	uint16_t iid;
+	uint16_t rid;
+	uint16_t crc;
+};
+
+BUILD_ASSERT(sizeof(struct flash_record) == 24, "unexpected padding of flash records");
+
+/**
+ * Written when the records of the oldest block are consumed only partially,
+ * so that they are not uploaded again after a reboot. Each record slot has a
+ * marker slot, filled from the end of the block, as flash cannot be rewritten
+ * without erasing; the marker of the last consumed record is written.
+ */
+struct consumed_marker {
+	uint32_t magic;
+	uint32_t index;
+};
+
+struct block_info {
+	// SEQ_NONE if the block holds no records
+	uint32_t seq;
+	uint16_t count;
+	bool erased;
+};
+
+static const struct flash_area *area;
+static size_t block_size;
+static size_t blocks_count;
+static size_t records_per_block;
+static struct block_info blocks[CONFIG_APP_FLASH_LOG_MAX_BLOCKS];
+
+static size_t head_block;
+static size_t tail_block;
+// number of already consumed records of the tail block
+static size_t tail_consumed;
+// number of entries consumed or dropped since boot, see flash_log_read()
+static uint32_t tail_position;
+static uint32_t next_seq = SEQ_NONE + 1;
+static size_t records_count;
+static uint32_t dropped_count;
+
+static off_t block_offset(size_t block)
+{
+	return (off_t)(block * block_size);
+}
+
+static off_t record_offset(size_t block, size_t index)
+{
+	return block_offset(block) + sizeof(struct block_header) +
+	       index * sizeof(struct flash_record);
+}
+
+static off_t marker_offset(size_t block, size_t index)
+{
+	return block_offset(block) + (off_t)block_size -
+	       (off_t)((index + 1) * sizeof(struct consumed_marker));
+}
+
+static bool is_erased(const void *data, size_t size)
+{
+	const uint8_t *bytes = (const uint8_t *)data;
+	uint8_t erased_val = flash_area_erased_val(area);
+
+	for (size_t i = 0; i < size; i++) {
+		if (bytes[i] != erased_val) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static uint16_t record_crc(const struct flash_record *record)
+{
+	return crc16_ccitt(0xffff, (const uint8_t *)record, offsetof(struct flash_record, crc));
+}
+
+static int erase_block(size_t block)
+{
+	int err = flash_area_erase(area, block_offset(block), block_size);
+
+	blocks[block] = (struct block_info){ .seq = SEQ_NONE, .erased = !err };
+	if (err) {
+		LOG_ERR("Could not erase block %zu: %d", block, err);
+	}
+	return err;
+}
+
+// records are appended without gaps, so the first erased slot ends the block
+static uint16_t count_records(size_t block)
+{
+	size_t low = 0;
+	size_t high = records_per_block;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		struct flash_record record;
+
+		if (flash_area_read(area, record_offset(block, mid), &record, sizeof(record)) ||
+		    !is_erased(&record, sizeof(record))) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return (uint16_t)low;
+}
+
+static void write_consumed_marker(size_t block, size_t consumed)
+{
+	struct consumed_marker marker = { .magic = CONSUMED_MAGIC, .index = consumed - 1 };
+	int err = flash_area_write(area, marker_offset(block, consumed - 1), &marker,
+				   sizeof(marker));
+
+	if (err) {
+		// the records will be uploaded again after a reboot
+		LOG_WRN("Could not mark records of block %zu as consumed: %d", block, err);
+	}
+}
+
+// markers are written in increasing order, but not for every record
+static size_t read_consumed(size_t block)
+{
+	for (size_t i = blocks[block].count; i > 0; i--) {
+		struct consumed_marker marker;
+
+		if (!flash_area_read(area, marker_offset(block, i - 1), &marker, sizeof(marker)) &&
+		    marker.magic == CONSUMED_MAGIC && marker.index == i - 1) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+static int open_block(size_t block)
+{
+	if (blocks[block].seq != SEQ_NONE) {
+		// the log is full and this is the oldest block
+		size_t lost = blocks[block].count - tail_consumed;
+
+		LOG_WRN("Log full, dropping %zu oldest records", lost);
+		dropped_count += lost;
+		records_count -= lost;
+		tail_position += lost;
+		blocks[block].seq = SEQ_NONE;
+		blocks[block].erased = false;
+		tail_block = (block + 1) % blocks_count;
+		tail_consumed = 0;
+	}
+
+	if (!blocks[block].erased && erase_block(block)) {
+		return -EIO;
+	}
+
+	struct block_header header = { .magic = BLOCK_MAGIC, .seq = next_seq };
+	int err = flash_area_write(area, block_offset(block), &header, sizeof(header));
+
+	if (err) {
+		blocks[block].erased = false;
+		return err;
+	}
+
+	blocks[block] = (struct block_info){ .seq = next_seq++ };
+	head_block = block;
+	if (!records_count) {
+		tail_block = block;
+		tail_consumed = 0;
+	}
+	return 0;
+}
+
+int flash_log_init(void)
+{
+	int err = flash_area_open(FLASH_LOG_AREA_ID, &area);
+
+	if (err) {
+		LOG_ERR("Could not open the sample_log partition: %d", err);
+		return err;
+	}
+
+	struct flash_pages_info page;
+
+	err = flash_get_page_info_by_offs(flash_area_get_device(area), area->fa_off, &page);
+	if (err) {
+		LOG_ERR("Could not get the sector size: %d", err);
+		goto fail;
+	}
+
+	// blocks consist of whole sectors, so that the RAM index has a bounded size
+	size_t sectors_count = area->fa_size / page.size;
+
+	block_size = DIV_ROUND_UP(sectors_count, AVS_ARRAY_SIZE(blocks)) * page.size;
+	blocks_count = area->fa_size / block_size;
+	records_per_block = MIN((block_size - sizeof(struct block_header)) /
+					(sizeof(struct flash_record) + sizeof(struct consumed_marker)),
+				UINT16_MAX);
+
+	if (blocks_count < 2) {
+		LOG_ERR("The sample_log partition must span at least 2 sectors");
+		err = -EINVAL;
+		goto fail;
+	}
+
+	uint32_t min_seq = UINT32_MAX;
+	uint32_t max_seq = SEQ_NONE;
+
+	head_block = blocks_count - 1;
+	tail_block = 0;
+	records_count = 0;
+
+	for (size_t i = 0; i < blocks_count; i++) {
+		struct block_header header;
+
+		blocks[i] = (struct block_info){ .seq = SEQ_NONE };
+		if (flash_area_read(area, block_offset(i), &header, sizeof(header))) {
+			continue;
+		}
+
+		if (header.magic != BLOCK_MAGIC || header.seq == SEQ_NONE) {
+			// the header is written right after erasing the whole block
+			blocks[i].erased = is_erased(&header, sizeof(header));
+			continue;
+		}
+
+		blocks[i].seq = header.seq;
+		blocks[i].count = (uint16_t)records_per_block;
+		if (header.seq < min_seq) {
+			min_seq = header.seq;
+			tail_block = i;
+		}
+		if (header.seq > max_seq) {
+			max_seq = header.seq;
+			head_block = i;
+		}
+	}
+
+	if (max_seq != SEQ_NONE) {
+		// only the newest block may be partially filled
+		blocks[head_block].count = count_records(head_block);
+		next_seq = max_seq + 1;
+	}
+
+	tail_consumed = max_seq != SEQ_NONE ? read_consumed(tail_block) : 0;
+	tail_position = 0;
+	for (size_t i = 0; i < blocks_count; i++) {
+		if (blocks[i].seq != SEQ_NONE) {
+			records_count += blocks[i].count;
+		}
+	}
+	records_count -= tail_consumed;
+
+	LOG_INF("%zu blocks of %zu bytes, %zu records pending", blocks_count, block_size,
+		records_count);
+	return 0;
+
+fail:
+	flash_area_close(area);
+	area = NULL;
+	return err;
+}
+
+int flash_log_append(const struct sample_record *record)
+{
+	if (!area) {
+		return -ENODEV;
+	}
+
+	if (blocks[head_block].seq == SEQ_NONE || blocks[head_block].count >= records_per_block) {
+		int err = open_block((head_block + 1) % blocks_count);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	struct flash_record entry = { .value = record->value,
+				      .oid = record->oid,
+				      .iid = record->iid,
+				      .rid = record->rid };
+
+	avs_time_real_to_scalar(&entry.timestamp_ms, AVS_TIME_MS, record->timestamp);
+	entry.crc = record_crc(&entry);
+
+	off_t offset = record_offset(head_block, blocks[head_block].count);
+	int err = flash_area_write(area, offset, &entry, sizeof(entry));
+
+	// the slot may have been partially written - never reuse it
+	blocks[head_block].count++;
+	records_count++;
+	return err;
+}
+
+size_t flash_log_read(struct sample_record *out_records, size_t max_count, uint32_t *out_position,
+		      size_t *out_span)
+{
+	size_t block = tail_block;
+	size_t index = tail_consumed;
+	size_t read_count = 0;
+
+	*out_position = tail_position;
+	*out_span = 0;
+	while (read_count < max_count && *out_span < records_count) {
+		if (index >= blocks[block].count) {
+			block = (block + 1) % blocks_count;
+			index = 0;
+			continue;
+		}
+
+		struct flash_record entry;
+
+		++*out_span;
+		if (flash_area_read(area, record_offset(block, index++), &entry, sizeof(entry)) ||
+		    entry.crc != record_crc(&entry)) {
+			LOG_WRN("Skipping a corrupted record");
+			continue;
+		}
+
+		out_records[read_count++] = (struct sample_record){
+			.timestamp = avs_time_real_from_scalar(entry.timestamp_ms, AVS_TIME_MS),
+			.value = entry.value,
+			.oid = entry.oid,
+			.iid = entry.iid,
+			.rid = entry.rid
+		};
+	}
+	return read_count;
+}
+
+void flash_log_consume(uint32_t position, size_t span)
+{
+	// entries dropped since they were read are not there anymore
+	int32_t remaining = (int32_t)(position + (uint32_t)span - tail_position);
+	size_t count = remaining > 0 ? MIN((size_t)remaining, records_count) : 0;
+
+	while (count) {
+		size_t consumed = MIN(count, blocks[tail_block].count - tail_consumed);
+
+		tail_consumed += consumed;
+		tail_position += consumed;
+		records_count -= consumed;
+		count -= consumed;
+
+		if (tail_consumed < records_per_block) {
+			// the newest block, still open for appending
+			write_consumed_marker(tail_block, tail_consumed);
+			break;
+		}
+
+		erase_block(tail_block);
+		tail_block = (tail_block + 1) % blocks_count;
+		tail_consumed = 0;
+	}
+}
+
+size_t flash_log_count(void)
+{
+	return records_count;
+}
+
+uint32_t flash_log_dropped_count(void)
+{
+	return dropped_count;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sample_buffer.h"
+
+#ifdef CONFIG_APP_FLASH_LOG
+
+/**
+ * Mounts the append-only log of sample records stored in the sample_log
+ * partition. The partition is divided into fixed-size blocks of whole erase
+ * sectors, written in a round-robin fashion, so that all sectors wear evenly.
+ * Only the position of the oldest and the newest record of each block is kept
+ * in RAM.
+ */
+int flash_log_init(void);
+
+/**
+ * Appends @p record to the log. If the log is full, the oldest block is erased
+ * and its records are dropped.
+ */
+int flash_log_append(const struct sample_record *record);
+
+/**
+ * Reads up to @p max_count oldest records without consuming them. Records that
+ * fail the integrity check are skipped.
+ *
+ * @param out_position Set to the position of the first read entry, to be passed
+ *                     to flash_log_consume().
+ * @param out_span     Set to the number of log entries covered by the read
+ *                     records, including the skipped ones, to be passed to
+ *                     flash_log_consume().
+ *
+ * @returns Number of records stored in @p out_records.
+ */
+size_t flash_log_read(struct sample_record *out_records, size_t max_count, uint32_t *out_position,
+		      size_t *out_span);
+
+/**
+ * Consumes @p span entries starting at @p position, as returned by
+ * flash_log_read(). Entries that have been dropped in the meantime, because
+ * the log was full, are skipped, so that no entry that has not been read is
+ * consumed. Blocks whose all entries have been consumed are erased; otherwise,
+ * the number of consumed entries is stored in flash, so that they are not read
+ * again after a reboot.
+ */
+void flash_log_consume(uint32_t position, size_t span);
+
+size_t flash_log_count(void);
+
+/**
+ * Returns the number of records dropped since boot, because the log was full.
+ */
+uint32_t flash_log_dropped_count(void);
+
+#endif // CONFIG_APP_FLASH_LOG
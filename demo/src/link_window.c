@@ -0,0 +1,263 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+#include <avsystem/commons/avs_sched.h>
+
+#include "link_window.h"
+#include "sensors.h"
+
+LOG_MODULE_REGISTER(link_window);
+
+#define MAX_DEFER_MS (CONFIG_APP_LINK_WINDOW_MAX_DEFER_S * INT64_C(1000))
+
+// the backends report events from their own threads
+static K_MUTEX_DEFINE(window_mutex);
+static anjay_t *window_anjay;
+static struct update_task *window_sensors_task;
+static avs_sched_handle_t expedite_handle;
+static avs_sched_handle_t realign_handle;
+
+static struct link_window_status status = { .wakeup_at_ms = -1,
+					    .psm_tau_s = -1,
+					    .psm_active_time_s = -1,
+					    .edrx_cycle_s = -1.0f,
+					    .edrx_ptw_s = -1.0f };
+// the sensors have already been expedited for the current or upcoming wakeup
+static bool expedited;
+
+static avs_time_monotonic_t uptime_to_monotonic(int64_t uptime_ms)
+{
+	return avs_time_monotonic_add(
+		avs_time_monotonic_now(),
+		avs_time_duration_from_scalar(uptime_ms - k_uptime_get(), AVS_TIME_MS));
+}
+
+static void expedite_job(avs_sched_t *sched, const void *unused)
+{
+	(void)sched;
+	(void)unused;
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	if (!window_anjay) {
+		k_mutex_unlock(&window_mutex);
+		return;
+	}
+
+	struct update_task *sensors_task = window_sensors_task;
+	int64_t active_ms = status.psm_active_time_s > 0 ? status.psm_active_time_s * INT64_C(1000)
+							 : CONFIG_APP_LINK_WINDOW_LEAD_MS;
+	// the sensors that would be due while the radio is on are sampled now
+	int64_t horizon_ms = MAX(status.wakeup_at_ms, k_uptime_get()) + active_ms;
+
+	k_mutex_unlock(&window_mutex);
+
+	sensors_expedite(uptime_to_monotonic(horizon_ms));
+	update_scheduler_set_deadline(sensors_task, avs_time_monotonic_now());
+	update_scheduler_flush_soon();
+}
+
+// must be called with window_mutex locked
+static void schedule_expedite(int64_t delay_ms)
+{
+	if (!window_anjay) {
+		return;
+	}
+
+	avs_time_duration_t delay = avs_time_duration_from_scalar(MAX(delay_ms, 0), AVS_TIME_MS);
+
+	avs_sched_del(&expedite_handle);
+	AVS_SCHED_DELAYED(anjay_get_scheduler(window_anjay), &expedite_handle, delay, expedite_job,
+			  NULL, 0);
+}
+
+/**
+ * The deadline of the sensors task may have been set while the modem was
+ * awake, e.g. by the run expedited before the wakeup, so it is aligned again
+ * once the modem falls asleep.
+ */
+static void realign_job(avs_sched_t *sched, const void *unused)
+{
+	(void)sched;
+	(void)unused;
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	struct update_task *sensors_task = window_sensors_task;
+
+	k_mutex_unlock(&window_mutex);
+
+	if (sensors_task) {
+		update_scheduler_set_deadline(sensors_task,
+					      link_window_align(sensors_task->deadline));
+	}
+}
+
+void link_window_start(anjay_t *anjay, struct update_task *sensors_task)
+{
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	window_anjay = anjay;
+	window_sensors_task = sensors_task;
+	k_mutex_unlock(&window_mutex);
+
+	if (link_window_backend_start()) {
+		LOG_ERR("Could not start the link control backend");
+	}
+}
+
+void link_window_stop(void)
+{
+	link_window_backend_stop();
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	avs_sched_del(&expedite_handle);
+	avs_sched_del(&realign_handle);
+	window_anjay = NULL;
+	window_sensors_task = NULL;
+	k_mutex_unlock(&window_mutex);
+}
+
+avs_time_monotonic_t link_window_align(avs_time_monotonic_t deadline)
+{
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	int64_t wakeup_at_ms = status.asleep ? status.wakeup_at_ms : -1;
+
+	k_mutex_unlock(&window_mutex);
+
+	if (wakeup_at_ms < 0 || !avs_time_monotonic_valid(deadline)) {
+		return deadline;
+	}
+
+	avs_time_monotonic_t aligned =
+		uptime_to_monotonic(wakeup_at_ms - CONFIG_APP_LINK_WINDOW_LEAD_MS);
+	avs_time_monotonic_t latest = avs_time_monotonic_add(
+		deadline, avs_time_duration_from_scalar(MAX_DEFER_MS, AVS_TIME_MS));
+
+	if (avs_time_monotonic_before(latest, aligned)) {
+		aligned = latest;
+	}
+	return avs_time_monotonic_before(aligned, deadline) ? deadline : aligned;
+}
+
+void link_window_get_status(struct link_window_status *out_status)
+{
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	*out_status = status;
+	k_mutex_unlock(&window_mutex);
+}
+
+void link_window_psm_updated(int32_t tau_s, int32_t active_time_s)
+{
+	LOG_INF("PSM: TAU %d s, active time %d s", tau_s, active_time_s);
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	status.psm_tau_s = tau_s;
+	status.psm_active_time_s = active_time_s;
+	k_mutex_unlock(&window_mutex);
+}
+
+void link_window_edrx_updated(float cycle_s, float ptw_s)
+{
+	LOG_INF("eDRX: cycle %d ms, PTW %d ms", (int)(cycle_s * 1000.0f), (int)(ptw_s * 1000.0f));
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	status.edrx_cycle_s = cycle_s;
+	status.edrx_ptw_s = ptw_s;
+	k_mutex_unlock(&window_mutex);
+}
+
+void link_window_sleep_entered(int64_t duration_ms)
+{
+	LOG_DBG("Modem asleep for %lld ms", duration_ms);
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	status.asleep = true;
+	status.wakeup_at_ms = duration_ms > 0 ? k_uptime_get() + duration_ms : -1;
+	expedited = false;
+	if (window_anjay) {
+		AVS_SCHED_NOW(anjay_get_scheduler(window_anjay), &realign_handle, realign_job, NULL,
+			      0);
+	}
+	k_mutex_unlock(&window_mutex);
+}
+
+void link_window_wakeup_expected(int64_t in_ms)
+{
+	LOG_DBG("Modem wakes up in %lld ms", in_ms);
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	status.wakeup_at_ms = k_uptime_get() + in_ms;
+	if (!expedited) {
+		expedited = true;
+		status.planned_wakeups++;
+		schedule_expedite(in_ms - CONFIG_APP_LINK_WINDOW_LEAD_MS);
+	}
+	k_mutex_unlock(&window_mutex);
+}
+
+void link_window_woken_up(void)
+{
+	LOG_DBG("Modem woken up");
+
+	k_mutex_lock(&window_mutex, K_FOREVER);
+	status.asleep = false;
+	status.wakeup_at_ms = -1;
+	// e.g. for mobile originated data, the fresh samples can still join it
+	if (!expedited) {
+		expedited = true;
+		status.unplanned_wakeups++;
+		schedule_expedite(0);
+	}
+	k_mutex_unlock(&window_mutex);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_link_window(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	struct link_window_status current;
+
+	link_window_get_status(&current);
+
+	if (!current.asleep) {
+		shell_print(sh, "Modem: awake");
+	} else if (current.wakeup_at_ms < 0) {
+		shell_print(sh, "Modem: asleep");
+	} else {
+		shell_print(sh, "Modem: asleep, waking up in %lld ms",
+			    current.wakeup_at_ms - k_uptime_get());
+	}
+	if (current.psm_tau_s >= 0) {
+		shell_print(sh, "PSM: TAU %d s, active time %d s", current.psm_tau_s,
+			    current.psm_active_time_s);
+	}
+	if (current.edrx_cycle_s >= 0.0f) {
+		shell_print(sh, "eDRX: cycle %d ms, PTW %d ms",
+			    (int)(current.edrx_cycle_s * 1000.0f),
+			    (int)(current.edrx_ptw_s * 1000.0f));
+	}
+	shell_print(sh, "Wakeups: %u planned, %u unplanned", current.planned_wakeups,
+		    current.unplanned_wakeups);
+	return 0;
+}
+
+SHELL_CMD_REGISTER(link_window, NULL, "Show the modem sleep state used to align sampling",
+		   cmd_link_window);
+#endif // CONFIG_SHELL
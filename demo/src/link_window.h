@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_time.h>
+
+#include "update_scheduler.h"
+
+struct link_window_status {
+	bool asleep;
+	// uptime at which the modem is expected to wake up, or -1 if unknown
+	int64_t wakeup_at_ms;
+	// -1 if PSM or eDRX is not in use
+	int32_t psm_tau_s;
+	int32_t psm_active_time_s;
+	float edrx_cycle_s;
+	float edrx_ptw_s;
+	uint32_t planned_wakeups;
+	uint32_t unplanned_wakeups;
+};
+
+/**
+ * Starts tracking the sleep of the LTE modem, reported by the link control
+ * library or by the fake backend. While the modem sleeps, runs of
+ * @p sensors_task are deferred to CONFIG_APP_LINK_WINDOW_LEAD_MS before the
+ * expected wakeup, by at most CONFIG_APP_LINK_WINDOW_MAX_DEFER_S. Once the
+ * wakeup is announced, the sensors due until the end of the following active
+ * time are sampled and the held notifications are flushed, so that the fresh
+ * data is sent in the same radio session.
+ */
+void link_window_start(anjay_t *anjay, struct update_task *sensors_task);
+void link_window_stop(void);
+
+/**
+ * @returns @p deadline of the sensors task, deferred while the modem sleeps.
+ */
+avs_time_monotonic_t link_window_align(avs_time_monotonic_t deadline);
+
+void link_window_get_status(struct link_window_status *out_status);
+
+// called by the backends, from any thread
+void link_window_psm_updated(int32_t tau_s, int32_t active_time_s);
+void link_window_edrx_updated(float cycle_s, float ptw_s);
+void link_window_sleep_entered(int64_t duration_ms);
+void link_window_wakeup_expected(int64_t in_ms);
+void link_window_woken_up(void);
+
+// implemented by the backend
+int link_window_backend_start(void);
+void link_window_backend_stop(void);
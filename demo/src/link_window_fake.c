@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/kernel.h>
+
+#include "link_window.h"
+
+/**
+ * Emulates the modem of a device in PSM: after each wakeup, the modem stays
+ * active for the active time and then sleeps until the periodic TAU, with the
+ * wakeup announced in advance, like the link control library does with
+ * CONFIG_LTE_LC_MODEM_SLEEP_NOTIFICATIONS.
+ */
+#define TAU_MS (CONFIG_APP_LINK_WINDOW_FAKE_TAU_S * INT64_C(1000))
+#define ACTIVE_TIME_MS (CONFIG_APP_LINK_WINDOW_FAKE_ACTIVE_TIME_S * INT64_C(1000))
+#define SLEEP_MS (TAU_MS - ACTIVE_TIME_MS)
+#define PRE_WARNING_MS CONFIG_APP_LINK_WINDOW_FAKE_PRE_WARNING_MS
+
+BUILD_ASSERT(SLEEP_MS > PRE_WARNING_MS, "the fake modem must sleep longer than the pre-warning");
+
+enum fake_phase {
+	FAKE_PHASE_ACTIVE,
+	FAKE_PHASE_ASLEEP,
+	FAKE_PHASE_WAKING_UP
+};
+
+static struct k_work_delayable fake_work;
+static enum fake_phase phase;
+
+static void fake_work_handler(struct k_work *work)
+{
+	(void)work;
+
+	switch (phase) {
+	case FAKE_PHASE_ACTIVE:
+		link_window_sleep_entered(SLEEP_MS);
+		phase = FAKE_PHASE_ASLEEP;
+		k_work_reschedule(&fake_work, K_MSEC(SLEEP_MS - PRE_WARNING_MS));
+		break;
+
+	case FAKE_PHASE_ASLEEP:
+		link_window_wakeup_expected(PRE_WARNING_MS);
+		phase = FAKE_PHASE_WAKING_UP;
+		k_work_reschedule(&fake_work, K_MSEC(PRE_WARNING_MS));
+		break;
+
+	case FAKE_PHASE_WAKING_UP:
+		link_window_woken_up();
+		phase = FAKE_PHASE_ACTIVE;
+		k_work_reschedule(&fake_work, K_MSEC(ACTIVE_TIME_MS));
+		break;
+	}
+}
+
+int link_window_backend_start(void)
+{
+	k_work_init_delayable(&fake_work, fake_work_handler);
+
+	// the modem is active right after registration
+	link_window_psm_updated(CONFIG_APP_LINK_WINDOW_FAKE_TAU_S,
+				CONFIG_APP_LINK_WINDOW_FAKE_ACTIVE_TIME_S);
+	phase = FAKE_PHASE_ACTIVE;
+	k_work_reschedule(&fake_work, K_MSEC(ACTIVE_TIME_MS));
+	return 0;
+}
+
+void link_window_backend_stop(void)
+{
+	struct k_work_sync sync;
+
+	k_work_cancel_delayable_sync(&fake_work, &sync);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <modem/lte_lc.h>
+#include <zephyr/logging/log.h>
+
+#include "link_window.h"
+
+LOG_MODULE_DECLARE(link_window);
+
+static void lte_handler(const struct lte_lc_evt *const evt)
+{
+	switch (evt->type) {
+	case LTE_LC_EVT_PSM_UPDATE:
+		link_window_psm_updated(evt->psm_cfg.tau, evt->psm_cfg.active_time);
+		break;
+
+	case LTE_LC_EVT_EDRX_UPDATE:
+		link_window_edrx_updated(evt->edrx_cfg.edrx, evt->edrx_cfg.ptw);
+		break;
+
+	case LTE_LC_EVT_MODEM_SLEEP_ENTER:
+		// the modem does not wake up by itself from the flight mode
+		if (evt->modem_sleep.type != LTE_LC_MODEM_SLEEP_FLIGHT_MODE) {
+			link_window_sleep_entered(evt->modem_sleep.time);
+		}
+		break;
+
+	case LTE_LC_EVT_MODEM_SLEEP_EXIT_PRE_WARNING:
+		link_window_wakeup_expected(evt->modem_sleep.time);
+		break;
+
+	case LTE_LC_EVT_MODEM_SLEEP_EXIT:
+		link_window_woken_up();
+		break;
+
+	default:
+		break;
+	}
+}
+
+int link_window_backend_start(void)
+{
+	int tau_s;
+	int active_time_s;
+
+	// the PSM parameters may have been negotiated before the handler is registered
+	if (!lte_lc_psm_get(&tau_s, &active_time_s)) {
+		link_window_psm_updated(tau_s, active_time_s);
+	}
+
+	lte_lc_register_handler(lte_handler);
+	return 0;
+}
+
+void link_window_backend_stop(void)
+{
+	if (lte_lc_deregister_handler(lte_handler)) {
+		LOG_WRN("Could not deregister the link control handler");
+	}
+}
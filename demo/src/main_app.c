@@ -24,12 +24,38 @@
 #include <anjay_zephyr/lwm2m.h>
 #include <anjay_zephyr/objects.h>
 
+#include "sensor_diagnostics.h"
 #include "sensors_config.h"
 #include "peripherals.h"
+#include "link_window.h"
+#include "motion_gate.h"
+#include "orientation.h"
+#include "perf_stats.h"
+#include "runtime_metrics.h"
+#include "sample_buffer.h"
 #include "status_led.h"
+#include "switch_events.h"
+#include "traffic_stats.h"
+#include "update_scheduler.h"
 
 LOG_MODULE_REGISTER(main_app);
+
 static const anjay_dm_object_def_t **location_obj;
+#ifdef CONFIG_APP_PERF_STATS
+static const anjay_dm_object_def_t **perf_stats_obj;
+#endif // CONFIG_APP_PERF_STATS
+#ifdef CONFIG_APP_RUNTIME_METRICS
+static const anjay_dm_object_def_t **runtime_metrics_obj;
+#endif // CONFIG_APP_RUNTIME_METRICS
+#ifdef CONFIG_APP_TRAFFIC_STATS
+static const anjay_dm_object_def_t **traffic_stats_obj;
+#endif // CONFIG_APP_TRAFFIC_STATS
+#ifdef CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+static const anjay_dm_object_def_t **sensor_diagnostics_obj;
+#endif // CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+#if ORIENTATION_AVAILABLE
+static const anjay_dm_object_def_t **orientation_obj;
+#endif // ORIENTATION_AVAILABLE
 #if BUZZER_AVAILABLE
 static const anjay_dm_object_def_t **buzzer_obj;
 #endif // BUZZER_AVAILABLE
@@ -39,55 +65,20 @@ static const anjay_dm_object_def_t **led_color_light_obj;
 #if SWITCH_AVAILABLE_ANY
 static const anjay_dm_object_def_t **switch_obj;
 #endif // SWITCH_AVAILABLE_ANY
-static avs_sched_handle_t update_objects_handle;
 
 #if LIGHT_CONTROL_AVAILABLE_ANY
-static const struct gpio_dt_spec leds[] = {
-#if LIGHT_CONTROL_AVAILABLE(0)
-	GPIO_DT_SPEC_GET(LIGHT_CONTROL_NODE(0), gpios),
-#endif // LIGHT_CONTROL_AVAILABLE(0)
-#if LIGHT_CONTROL_AVAILABLE(1)
-	GPIO_DT_SPEC_GET(LIGHT_CONTROL_NODE(1), gpios),
-#endif // LIGHT_CONTROL_AVAILABLE(1)
-#if LIGHT_CONTROL_AVAILABLE(2)
-	GPIO_DT_SPEC_GET(LIGHT_CONTROL_NODE(2), gpios),
-#endif // LIGHT_CONTROL_AVAILABLE(2)
-#if LIGHT_CONTROL_AVAILABLE(3)
-	GPIO_DT_SPEC_GET(LIGHT_CONTROL_NODE(3), gpios),
-#endif // LIGHT_CONTROL_AVAILABLE(3)
-};
+static const struct gpio_dt_spec leds[] = { LIGHT_CONTROL_TABLE };
 static const anjay_dm_object_def_t **light_control_obj;
 #endif // LIGHT_CONTROL_AVAILABLE_ANY
 
 #if PUSH_BUTTON_AVAILABLE_ANY
-static struct anjay_zephyr_ipso_button_instance buttons[] = {
-#if PUSH_BUTTON_AVAILABLE(0)
-	PUSH_BUTTON_GLUE_ITEM(0),
-#endif // PUSH_BUTTON_AVAILABLE(0)
-#if PUSH_BUTTON_AVAILABLE(1)
-	PUSH_BUTTON_GLUE_ITEM(1),
-#endif // PUSH_BUTTON_AVAILABLE(1)
-#if PUSH_BUTTON_AVAILABLE(2)
-	PUSH_BUTTON_GLUE_ITEM(2),
-#endif // PUSH_BUTTON_AVAILABLE(2)
-#if PUSH_BUTTON_AVAILABLE(3)
-	PUSH_BUTTON_GLUE_ITEM(3),
-#endif // PUSH_BUTTON_AVAILABLE(3)
-};
+static struct anjay_zephyr_ipso_button_instance buttons[] = { PUSH_BUTTON_TABLE };
 #endif // PUSH_BUTTON_AVAILABLE_ANY
 
 #if SWITCH_AVAILABLE_ANY
-static struct anjay_zephyr_switch_instance switches[] = {
-#if SWITCH_AVAILABLE(0)
-	SWITCH_BUTTON_GLUE_ITEM(0),
-#endif // SWITCH_AVAILABLE(0)
-#if SWITCH_AVAILABLE(1)
-	SWITCH_BUTTON_GLUE_ITEM(1),
-#endif // SWITCH_AVAILABLE(1)
-#if SWITCH_AVAILABLE(2)
-	SWITCH_BUTTON_GLUE_ITEM(2),
-#endif // SWITCH_AVAILABLE(2)
-};
+static struct anjay_zephyr_switch_instance switches[] = { SWITCH_TABLE };
+// set if some of the switches cannot raise interrupts
+static bool switches_polled;
 #endif // SWITCH_AVAILABLE_ANY
 struct anjay_zephyr_network_preferred_bearer_list_t anjay_zephyr_config_get_preferred_bearers(void);
 
@@ -99,6 +90,18 @@ static int register_objects(anjay_t *anjay)
 	}
 
 	sensors_install(anjay);
+#ifdef CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+	sensor_diagnostics_obj = sensor_diagnostics_object_create();
+	if (sensor_diagnostics_obj) {
+		anjay_register_object(anjay, sensor_diagnostics_obj);
+	}
+#endif // CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+#if ORIENTATION_AVAILABLE
+	orientation_obj = orientation_object_create();
+	if (orientation_obj) {
+		anjay_register_object(anjay, orientation_obj);
+	}
+#endif // ORIENTATION_AVAILABLE
 #if PUSH_BUTTON_AVAILABLE_ANY
 	anjay_zephyr_ipso_push_button_object_install(anjay, buttons, AVS_ARRAY_SIZE(buttons));
 #endif // PUSH_BUTTON_AVAILABLE_ANY
@@ -128,60 +131,146 @@ static int register_objects(anjay_t *anjay)
 	switch_obj = anjay_zephyr_switch_object_create(switches, AVS_ARRAY_SIZE(switches));
 	if (switch_obj) {
 		anjay_register_object(anjay, switch_obj);
+		switches_polled = switch_events_init(switches, AVS_ARRAY_SIZE(switches)) > 0;
 	}
 #endif // SWITCH_AVAILABLE_ANY
+
+#ifdef CONFIG_APP_PERF_STATS
+	perf_stats_obj = perf_stats_object_create();
+	if (perf_stats_obj) {
+		anjay_register_object(anjay, perf_stats_obj);
+	}
+#endif // CONFIG_APP_PERF_STATS
+#ifdef CONFIG_APP_RUNTIME_METRICS
+	runtime_metrics_obj = runtime_metrics_object_create();
+	if (runtime_metrics_obj) {
+		anjay_register_object(anjay, runtime_metrics_obj);
+	}
+#endif // CONFIG_APP_RUNTIME_METRICS
+#ifdef CONFIG_APP_TRAFFIC_STATS
+	traffic_stats_obj = traffic_stats_object_create();
+	if (traffic_stats_obj) {
+		anjay_register_object(anjay, traffic_stats_obj);
+	}
+#endif // CONFIG_APP_TRAFFIC_STATS
+
+	LOG_INF("Objects registered at %lld ms since boot", k_uptime_get());
 	return 0;
 }
 
-static void update_objects_frequent(anjay_t *anjay)
-{
 #if SWITCH_AVAILABLE_ANY
+static void update_switch_object(anjay_t *anjay)
+{
 	anjay_zephyr_switch_object_update(anjay, switch_obj);
+}
+
+static struct update_task switch_update_task = { .name = "switch",
+						 .run = update_switch_object };
 #endif // SWITCH_AVAILABLE_ANY
+
 #if BUZZER_AVAILABLE
+static void update_buzzer_object(anjay_t *anjay)
+{
 	anjay_zephyr_buzzer_object_update(anjay, buzzer_obj);
-#endif // BUZZER_AVAILABLE
 }
 
-static void update_objects_periodic(anjay_t *anjay)
+static struct update_task buzzer_update_task = { .name = "buzzer",
+						 .run = update_buzzer_object };
+#endif // BUZZER_AVAILABLE
+
+static struct update_task sensors_update_task;
+
+static void update_sensor_objects(anjay_t *anjay)
 {
-	anjay_zephyr_ipso_sensors_update(anjay);
-	anjay_zephyr_location_object_update(anjay, location_obj);
+	avs_time_monotonic_t deadline = sensors_update(anjay);
+
+#ifdef CONFIG_APP_LINK_WINDOW
+	deadline = link_window_align(deadline);
+#endif // CONFIG_APP_LINK_WINDOW
+	update_scheduler_set_deadline(&sensors_update_task, deadline);
 }
 
-static void update_objects(avs_sched_t *sched, const void *anjay_ptr)
-{
-	anjay_t *anjay = *(anjay_t *const *)anjay_ptr;
+static struct update_task sensors_update_task = { .name = "sensors",
+						  .run = update_sensor_objects,
+						  .flush = sensors_flush_held };
 
-	static size_t cycle;
+#if ORIENTATION_AVAILABLE
+static struct update_task orientation_update_task = { .name = "orientation",
+						      .run = orientation_update };
+#endif // ORIENTATION_AVAILABLE
 
-	update_objects_frequent(anjay);
-	if (cycle % 5 == 0) {
-		update_objects_periodic(anjay);
-	}
+static void update_location_object(anjay_t *anjay)
+{
+	anjay_zephyr_location_object_update(anjay, location_obj);
+#if MOTION_GATE_AVAILABLE
+	motion_gate_task_done();
+#endif // MOTION_GATE_AVAILABLE
+}
 
-	status_led_toggle();
+static struct update_task location_update_task = { .name = "location",
+						   .run = update_location_object };
 
-	cycle++;
-	AVS_SCHED_DELAYED(sched, &update_objects_handle,
-			  avs_time_duration_from_scalar(1, AVS_TIME_S), update_objects, &anjay,
-			  sizeof(anjay));
+static void add_update_task(struct update_task *task, int32_t period_ms)
+{
+	task->period = avs_time_duration_from_scalar(period_ms, AVS_TIME_MS);
+	update_scheduler_add(task);
 }
 
 static int init_update_objects(anjay_t *anjay)
 {
-	avs_sched_t *sched = anjay_get_scheduler(anjay);
+	LOG_INF("Anjay ready at %lld ms since boot", k_uptime_get());
 
-	update_objects(sched, &anjay);
+	// devices are accessed only now, after Register has been scheduled
+	sensors_init_start();
 
-	status_led_init();
+#if SWITCH_AVAILABLE_ANY
+	// switches are not polled, their changes are reported on GPIO interrupts
+	if (switch_obj) {
+		switch_events_start(anjay, switch_obj);
+		if (switches_polled) {
+			add_update_task(&switch_update_task, CONFIG_APP_SWITCH_POLL_PERIOD_MS);
+		}
+	}
+#endif // SWITCH_AVAILABLE_ANY
+#if BUZZER_AVAILABLE
+	add_update_task(&buzzer_update_task, CONFIG_APP_BUZZER_UPDATE_PERIOD_MS);
+#endif // BUZZER_AVAILABLE
+	// sensors keep track of their own deadlines
+	sensors_update_task.period = AVS_TIME_DURATION_INVALID;
+	update_scheduler_add(&sensors_update_task);
+#ifdef CONFIG_APP_LINK_WINDOW
+	link_window_start(anjay, &sensors_update_task);
+#endif // CONFIG_APP_LINK_WINDOW
+#if ORIENTATION_AVAILABLE
+	add_update_task(&orientation_update_task, 1000 / CONFIG_APP_ORIENTATION_RATE_HZ);
+#endif // ORIENTATION_AVAILABLE
+#if MOTION_GATE_AVAILABLE
+	// refreshing the location, especially with GNSS, is pointless while parked
+	motion_gate_start(&location_update_task, CONFIG_APP_LOCATION_UPDATE_PERIOD_MS);
+#else  // MOTION_GATE_AVAILABLE
+	add_update_task(&location_update_task, CONFIG_APP_LOCATION_UPDATE_PERIOD_MS);
+#endif // MOTION_GATE_AVAILABLE
+#ifdef CONFIG_APP_SAMPLE_BUFFER
+	sample_buffer_start();
+#endif // CONFIG_APP_SAMPLE_BUFFER
+
+	status_led_set_pattern(STATUS_LED_PATTERN_HEARTBEAT);
+
+	update_scheduler_start(anjay);
 
 	return 0;
 }
 
 static int clean_before_anjay_destroy(anjay_t *anjay)
 {
-	avs_sched_del(&update_objects_handle);
+#ifdef CONFIG_APP_LINK_WINDOW
+	link_window_stop();
+#endif // CONFIG_APP_LINK_WINDOW
+	update_scheduler_stop();
+#if SWITCH_AVAILABLE_ANY
+	switch_events_stop();
+#endif // SWITCH_AVAILABLE_ANY
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
 
 	return 0;
 }
@@ -201,6 +290,22 @@ static int release_objects(void)
 #if BUZZER_AVAILABLE
 	anjay_zephyr_buzzer_object_release(&buzzer_obj);
 #endif // BUZZER_AVAILABLE
+#ifdef CONFIG_APP_PERF_STATS
+	perf_stats_object_release(perf_stats_obj);
+#endif // CONFIG_APP_PERF_STATS
+#ifdef CONFIG_APP_RUNTIME_METRICS
+	runtime_metrics_object_release(runtime_metrics_obj);
+#endif // CONFIG_APP_RUNTIME_METRICS
+#ifdef CONFIG_APP_TRAFFIC_STATS
+	traffic_stats_object_release(traffic_stats_obj);
+#endif // CONFIG_APP_TRAFFIC_STATS
+#ifdef CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+	sensor_diagnostics_object_release(sensor_diagnostics_obj);
+#endif // CONFIG_APP_SENSOR_DIAGNOSTICS_OBJECT
+#if ORIENTATION_AVAILABLE
+	orientation_object_release(orientation_obj);
+#endif // ORIENTATION_AVAILABLE
+	sensors_release();
 	return 0;
 }
 
@@ -224,6 +329,9 @@ int main(void)
 {
 	LOG_INF("Initializing Anjay-zephyr-client demo " CONFIG_ANJAY_ZEPHYR_VERSION);
 
+	status_led_init();
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
+
 	anjay_zephyr_lwm2m_set_user_callback(lwm2m_callback);
 
 	anjay_zephyr_lwm2m_init_from_settings();
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+#include "motion_gate.h"
+#include "sensors.h"
+
+LOG_MODULE_REGISTER(motion_gate);
+
+#if MOTION_GATE_AVAILABLE
+// SENSOR_G is expressed in micrometers per second squared
+#define MILLI_G_TO_MS2_FACTOR (SENSOR_G / 1e9)
+
+#define MAX_PERIOD_MS (CONFIG_APP_MOTION_GATE_MAX_PERIOD_S * INT64_C(1000))
+
+static const struct device *const accelerometer = DEVICE_DT_GET(ACCELEROMETER_NODE);
+
+static struct update_task *gated_task;
+static int64_t base_period_ms;
+static int64_t current_period_ms;
+static bool moved;
+
+static double last_acceleration[3];
+static bool has_last_acceleration;
+
+// read through the sensors module, which may own the I/O of the device
+static int read_acceleration(double *out_values)
+{
+	for (size_t i = 0; i < sensors_installed_count(); i++) {
+		struct sensor_context *sensor = sensors_installed_get(i);
+
+		if (sensor->installed && sensor->device == accelerometer &&
+		    sensor->channel == SENSOR_CHAN_ACCEL_XYZ) {
+			return sensors_read_latest(sensor, out_values);
+		}
+	}
+	return -1;
+}
+
+static void motion_detected(void)
+{
+	moved = true;
+	if (current_period_ms > base_period_ms) {
+		LOG_INF("Motion detected, resuming updates of %s", gated_task->name);
+		current_period_ms = base_period_ms;
+		update_scheduler_set_deadline(gated_task, avs_time_monotonic_now());
+	}
+}
+
+static void poll_motion(anjay_t *anjay)
+{
+	(void)anjay;
+
+	double values[3];
+
+	if (read_acceleration(values)) {
+		// don't let the gated task starve because of the accelerometer
+		motion_detected();
+		return;
+	}
+
+	if (has_last_acceleration) {
+		double dx = values[0] - last_acceleration[0];
+		double dy = values[1] - last_acceleration[1];
+		double dz = values[2] - last_acceleration[2];
+
+		if (sqrt(dx * dx + dy * dy + dz * dz) >
+		    CONFIG_APP_MOTION_GATE_THRESHOLD_MG * MILLI_G_TO_MS2_FACTOR) {
+			motion_detected();
+		}
+	}
+
+	memcpy(last_acceleration, values, sizeof(last_acceleration));
+	has_last_acceleration = true;
+}
+
+static struct update_task motion_poll_task = { .name = "motion", .run = poll_motion };
+
+void motion_gate_start(struct update_task *task, int32_t period_ms)
+{
+	gated_task = task;
+	base_period_ms = period_ms;
+	current_period_ms = period_ms;
+	moved = true;
+	has_last_acceleration = false;
+
+	task->period = AVS_TIME_DURATION_INVALID;
+	update_scheduler_add(task);
+
+	motion_poll_task.period =
+		avs_time_duration_from_scalar(CONFIG_APP_MOTION_GATE_POLL_PERIOD_MS, AVS_TIME_MS);
+	update_scheduler_add(&motion_poll_task);
+}
+
+void motion_gate_task_done(void)
+{
+	if (moved) {
+		current_period_ms = base_period_ms;
+	} else if (current_period_ms < MAX_PERIOD_MS) {
+		current_period_ms = MIN(2 * current_period_ms, MAX_PERIOD_MS);
+		LOG_DBG("Stationary, next run of %s in %lld ms", gated_task->name, current_period_ms);
+	}
+	moved = false;
+
+	avs_time_duration_t period =
+		avs_time_duration_from_scalar(current_period_ms, AVS_TIME_MS);
+
+	update_scheduler_set_deadline(gated_task,
+				      avs_time_monotonic_add(avs_time_monotonic_now(), period));
+}
+#endif // MOTION_GATE_AVAILABLE
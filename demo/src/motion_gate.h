@@ -0,0 +1,41 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+#include "peripherals.h"
+#include "update_scheduler.h"
+
+#define MOTION_GATE_AVAILABLE (IS_ENABLED(CONFIG_APP_MOTION_GATE) && ACCELEROMETER_AVAILABLE)
+
+/**
+ * Adds @p task to the update scheduler, so that it is run every @p period_ms
+ * only while the accelerometer reports motion. While the device is stationary,
+ * the interval between runs is doubled after each run, up to
+ * CONFIG_APP_MOTION_GATE_MAX_PERIOD_S. Once motion is detected, the task is run
+ * immediately and then again every @p period_ms.
+ */
+void motion_gate_start(struct update_task *task, int32_t period_ms);
+
+/**
+ * Must be called at the end of each run of the gated task to schedule the next
+ * one.
+ */
+void motion_gate_task_done(void);
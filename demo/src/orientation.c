@@ -0,0 +1,418 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LwM2M Object: Orientation
+ * ID: 26243, URN: N/A, Optional, Single
+ *
+ * Orientation of the device, fused on the device from the accelerometer,
+ * gyrometer and magnetometer, so that a single object replaces the nine
+ * values of the three raw sensor objects.
+ */
+#include <math.h>
+#include <string.h>
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "orientation.h"
+#include "sensors.h"
+#include "update_scheduler.h"
+
+LOG_MODULE_REGISTER(orientation);
+
+/**
+ * Quaternion W: R, Single, Mandatory
+ * type: float, range: -1..1, unit: N/A
+ * Scalar part of the unit quaternion rotating vectors from the sensor frame
+ * to the North-East-Down frame.
+ */
+#define RID_QUATERNION_W 0
+
+/**
+ * Quaternion X: R, Single, Mandatory
+ * type: float, range: -1..1, unit: N/A
+ */
+#define RID_QUATERNION_X 1
+
+/**
+ * Quaternion Y: R, Single, Mandatory
+ * type: float, range: -1..1, unit: N/A
+ */
+#define RID_QUATERNION_Y 2
+
+/**
+ * Quaternion Z: R, Single, Mandatory
+ * type: float, range: -1..1, unit: N/A
+ */
+#define RID_QUATERNION_Z 3
+
+/**
+ * Heading: R, Single, Mandatory
+ * type: float, range: 0..360, unit: deg
+ * Direction of the x axis of the sensor frame, clockwise from the magnetic
+ * north.
+ */
+#define RID_HEADING 4
+
+#define RAD_TO_DEG (180.0f / (float)M_PI)
+
+// below that, gravity and the magnetic field are too close to be told apart
+#define MIN_CROSS_NORM 1e-3f
+
+static float vector_norm(const float *v)
+{
+	return sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+static void cross(const float *a, const float *b, float *out)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static bool normalize(float *v, size_t count)
+{
+	float sum = 0.0f;
+
+	for (size_t i = 0; i < count; i++) {
+		sum += v[i] * v[i];
+	}
+	if (sum <= 0.0f) {
+		return false;
+	}
+
+	float inv_norm = 1.0f / sqrtf(sum);
+
+	for (size_t i = 0; i < count; i++) {
+		v[i] *= inv_norm;
+	}
+	return true;
+}
+
+/**
+ * Builds the rotation whose rows are the north, east and down directions
+ * expressed in the sensor frame and converts it into a quaternion.
+ */
+static bool absolute_orientation(const float *accel, const float *magn, float *out_q)
+{
+	// the accelerometer at rest measures the reaction to gravity, i.e. "up"
+	float down[3] = { -accel[0], -accel[1], -accel[2] };
+	float east[3];
+	float north[3];
+
+	if (!normalize(down, 3)) {
+		return false;
+	}
+	cross(down, magn, east);
+	if (vector_norm(east) < MIN_CROSS_NORM * vector_norm(magn) || !normalize(east, 3)) {
+		return false;
+	}
+	cross(east, down, north);
+
+	float m00 = north[0], m01 = north[1], m02 = north[2];
+	float m10 = east[0], m11 = east[1], m12 = east[2];
+	float m20 = down[0], m21 = down[1], m22 = down[2];
+	float trace = m00 + m11 + m22;
+	float s;
+
+	// Shepperd's method, dividing by the largest of the four candidates
+	if (trace > 0.0f) {
+		s = 2.0f * sqrtf(trace + 1.0f);
+		out_q[0] = 0.25f * s;
+		out_q[1] = (m21 - m12) / s;
+		out_q[2] = (m02 - m20) / s;
+		out_q[3] = (m10 - m01) / s;
+	} else if (m00 > m11 && m00 > m22) {
+		s = 2.0f * sqrtf(1.0f + m00 - m11 - m22);
+		out_q[0] = (m21 - m12) / s;
+		out_q[1] = 0.25f * s;
+		out_q[2] = (m01 + m10) / s;
+		out_q[3] = (m02 + m20) / s;
+	} else if (m11 > m22) {
+		s = 2.0f * sqrtf(1.0f + m11 - m00 - m22);
+		out_q[0] = (m02 - m20) / s;
+		out_q[1] = (m01 + m10) / s;
+		out_q[2] = 0.25f * s;
+		out_q[3] = (m12 + m21) / s;
+	} else {
+		s = 2.0f * sqrtf(1.0f + m22 - m00 - m11);
+		out_q[0] = (m10 - m01) / s;
+		out_q[1] = (m02 + m20) / s;
+		out_q[2] = (m12 + m21) / s;
+		out_q[3] = 0.25f * s;
+	}
+	return normalize(out_q, 4);
+}
+
+void orientation_filter_reset(struct orientation_filter *filter)
+{
+	memset(filter, 0, sizeof(*filter));
+	filter->q[0] = 1.0f;
+}
+
+void orientation_filter_update(struct orientation_filter *filter, const float *gyro,
+			       const float *accel, const float *magn, float dt)
+{
+	float *q = filter->q;
+	float measured[4];
+	bool has_measured = absolute_orientation(accel, magn, measured);
+
+	if (!filter->initialized) {
+		if (has_measured) {
+			memcpy(q, measured, sizeof(measured));
+			filter->initialized = true;
+		}
+		return;
+	}
+
+	// q' = q + dt / 2 * q * (0, gyro)
+	float half_dt = 0.5f * dt;
+	float w = q[0], x = q[1], y = q[2], z = q[3];
+
+	q[0] += half_dt * (-x * gyro[0] - y * gyro[1] - z * gyro[2]);
+	q[1] += half_dt * (w * gyro[0] + y * gyro[2] - z * gyro[1]);
+	q[2] += half_dt * (w * gyro[1] - x * gyro[2] + z * gyro[0]);
+	q[3] += half_dt * (w * gyro[2] + x * gyro[1] - y * gyro[0]);
+
+	if (has_measured) {
+		float alpha = dt / (CONFIG_APP_ORIENTATION_TIME_CONSTANT_MS / 1000.0f + dt);
+		float dot = q[0] * measured[0] + q[1] * measured[1] + q[2] * measured[2] +
+			    q[3] * measured[3];
+		// q and -q are the same rotation, blend with the closer one
+		float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+		for (size_t i = 0; i < 4; i++) {
+			q[i] += alpha * (sign * measured[i] - q[i]);
+		}
+	}
+
+	if (!normalize(q, 4)) {
+		orientation_filter_reset(filter);
+	}
+}
+
+float orientation_filter_heading(const struct orientation_filter *filter)
+{
+	const float *q = filter->q;
+	float heading = RAD_TO_DEG * atan2f(2.0f * (q[1] * q[2] + q[0] * q[3]),
+					    1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+
+	return heading < 0.0f ? heading + 360.0f : heading;
+}
+
+#if ORIENTATION_AVAILABLE
+enum orientation_input {
+	INPUT_GYRO,
+	INPUT_ACCEL,
+	INPUT_MAGN,
+	INPUTS_COUNT
+};
+
+static const enum sensor_channel INPUT_CHANNELS[INPUTS_COUNT] = {
+	[INPUT_GYRO] = SENSOR_CHAN_GYRO_XYZ,
+	[INPUT_ACCEL] = SENSOR_CHAN_ACCEL_XYZ,
+	[INPUT_MAGN] = SENSOR_CHAN_MAGN_XYZ
+};
+
+static struct sensor_context *inputs[INPUTS_COUNT];
+static struct orientation_filter filter;
+// timestamp of the last integrated gyrometer sample
+static int64_t last_sample_ms;
+static float reported_q[4];
+static bool reported;
+
+static struct sensor_context *find_sensor(enum sensor_channel channel)
+{
+	for (size_t i = 0; i < sensors_installed_count(); i++) {
+		struct sensor_context *sensor = sensors_installed_get(i);
+
+		if (sensor->installed && sensor->channel == channel) {
+			return sensor;
+		}
+	}
+	return NULL;
+}
+
+static bool shares_device(size_t input)
+{
+	for (size_t i = 0; i < input; i++) {
+		if (inputs[i]->device == inputs[input]->device) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Takes a new sample of each input. Devices providing several of them, e.g.
+ * the accelerometer and gyrometer of a single IMU, are fetched only once.
+ */
+static int read_inputs(float (*out_values)[3], int64_t *out_gyro_timestamp_ms)
+{
+	for (size_t i = 0; i < INPUTS_COUNT; i++) {
+		double values[3];
+		int64_t timestamp_ms;
+
+		// sensors whose devices are not ready are uninstalled
+		if (!inputs[i] || !inputs[i]->installed ||
+		    sensors_sample(inputs[i], !shares_device(i), values, &timestamp_ms)) {
+			return -1;
+		}
+		for (size_t j = 0; j < AVS_ARRAY_SIZE(values); j++) {
+			out_values[i][j] = (float)values[j];
+		}
+		if (i == INPUT_GYRO) {
+			*out_gyro_timestamp_ms = timestamp_ms;
+		}
+	}
+	return 0;
+}
+
+static bool exceeds_deadband(void)
+{
+	if (!reported) {
+		return true;
+	}
+
+	// the angle of the rotation between two unit quaternions is 2 * acos(|dot|)
+	float dot = fabsf(filter.q[0] * reported_q[0] + filter.q[1] * reported_q[1] +
+			  filter.q[2] * reported_q[2] + filter.q[3] * reported_q[3]);
+
+	return dot < cosf(CONFIG_APP_ORIENTATION_DEADBAND_DEG / (2.0f * RAD_TO_DEG));
+}
+
+static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+
+	anjay_dm_emit(ctx, 0);
+	return 0;
+}
+
+static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	// nothing is known until the first sample of all three sensors
+	anjay_dm_resource_presence_t presence =
+		filter.initialized ? ANJAY_DM_RES_PRESENT : ANJAY_DM_RES_ABSENT;
+
+	anjay_dm_emit_res(ctx, RID_QUATERNION_W, ANJAY_DM_RES_R, presence);
+	anjay_dm_emit_res(ctx, RID_QUATERNION_X, ANJAY_DM_RES_R, presence);
+	anjay_dm_emit_res(ctx, RID_QUATERNION_Y, ANJAY_DM_RES_R, presence);
+	anjay_dm_emit_res(ctx, RID_QUATERNION_Z, ANJAY_DM_RES_R, presence);
+	anjay_dm_emit_res(ctx, RID_HEADING, ANJAY_DM_RES_R, presence);
+	return 0;
+}
+
+static int resource_read(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			 anjay_iid_t iid, anjay_rid_t rid, anjay_riid_t riid,
+			 anjay_output_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+	(void)riid;
+
+	switch (rid) {
+	case RID_QUATERNION_W:
+	case RID_QUATERNION_X:
+	case RID_QUATERNION_Y:
+	case RID_QUATERNION_Z:
+		return anjay_ret_float(ctx, filter.q[rid - RID_QUATERNION_W]);
+
+	case RID_HEADING:
+		return anjay_ret_float(ctx, orientation_filter_heading(&filter));
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static const anjay_dm_object_def_t OBJ_DEF = { .oid = 26243,
+					       .handlers = { .list_instances = list_instances,
+							     .list_resources = list_resources,
+							     .resource_read = resource_read } };
+
+static const anjay_dm_object_def_t *obj_def_ptr = &OBJ_DEF;
+
+const anjay_dm_object_def_t **orientation_object_create(void)
+{
+	orientation_filter_reset(&filter);
+	last_sample_ms = 0;
+	reported = false;
+
+	// the sensors are installed before, and sampled at the rate of the filter
+	for (size_t i = 0; i < INPUTS_COUNT; i++) {
+		inputs[i] = find_sensor(INPUT_CHANNELS[i]);
+		if (inputs[i]) {
+			sensors_request_interval(inputs[i], 1000 / CONFIG_APP_ORIENTATION_RATE_HZ);
+		}
+	}
+	return &obj_def_ptr;
+}
+
+void orientation_object_release(const anjay_dm_object_def_t **def)
+{
+	(void)def;
+}
+
+void orientation_update(anjay_t *anjay)
+{
+	float values[INPUTS_COUNT][3];
+	int64_t sample_ms;
+
+	if (read_inputs(values, &sample_ms)) {
+		return;
+	}
+	// the hub may not have published a new sample since the previous step,
+	// and integrating the same angular rate twice would corrupt the result
+	if (filter.initialized && sample_ms == last_sample_ms) {
+		return;
+	}
+
+	float dt = filter.initialized ? (sample_ms - last_sample_ms) / 1000.0f : 0.0f;
+	bool was_initialized = filter.initialized;
+
+	last_sample_ms = sample_ms;
+	orientation_filter_update(&filter, values[INPUT_GYRO], values[INPUT_ACCEL],
+				  values[INPUT_MAGN], dt);
+
+	if (!filter.initialized || !exceeds_deadband()) {
+		return;
+	}
+
+	if (!was_initialized) {
+		LOG_INF("Initial heading: %d deg", (int)orientation_filter_heading(&filter));
+	}
+
+	memcpy(reported_q, filter.q, sizeof(reported_q));
+	reported = true;
+	for (anjay_rid_t rid = RID_QUATERNION_W; rid <= RID_HEADING; rid++) {
+		update_scheduler_notify_changed(anjay, OBJ_DEF.oid, 0, rid, false);
+	}
+}
+#endif // ORIENTATION_AVAILABLE
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+#include <anjay/dm.h>
+
+#include "peripherals.h"
+
+#define ORIENTATION_AVAILABLE                                                                      \
+	(IS_ENABLED(CONFIG_APP_ORIENTATION) && ACCELEROMETER_AVAILABLE && GYROMETER_AVAILABLE &&   \
+	 MAGNETOMETER_AVAILABLE)
+
+/**
+ * Complementary filter estimating the rotation from the sensor frame to the
+ * North-East-Down frame. The gyrometer is integrated at every step, and the
+ * result is pulled towards the orientation given by gravity and the magnetic
+ * field, with a time constant of CONFIG_APP_ORIENTATION_TIME_CONSTANT_MS.
+ */
+struct orientation_filter {
+	// w, x, y, z
+	float q[4];
+	bool initialized;
+};
+
+void orientation_filter_reset(struct orientation_filter *filter);
+
+/**
+ * @param gyro  Angular rate [rad/s].
+ * @param accel Acceleration, in any unit.
+ * @param magn  Magnetic field, in any unit.
+ * @param dt    Time since the previous step [s].
+ */
+void orientation_filter_update(struct orientation_filter *filter, const float *gyro,
+			       const float *accel, const float *magn, float dt);
+
+/**
+ * @returns Heading of the x axis of the sensor frame, clockwise from the
+ *          magnetic north, in degrees from 0 to 360.
+ */
+float orientation_filter_heading(const struct orientation_filter *filter);
+
+#if ORIENTATION_AVAILABLE
+const anjay_dm_object_def_t **orientation_object_create(void);
+void orientation_object_release(const anjay_dm_object_def_t **def);
+
+/**
+ * Runs a step of the filter with new samples of the sensors, taken at the
+ * rate of the filter (see sensors_request_interval()), and notifies Anjay once
+ * the orientation changes by more than CONFIG_APP_ORIENTATION_DEADBAND_DEG.
+ * Each gyrometer sample is integrated once, over the time since the previous
+ * one. Meant to be run every 1000 / CONFIG_APP_ORIENTATION_RATE_HZ
+ * milliseconds.
+ */
+void orientation_update(anjay_t *anjay);
+#endif // ORIENTATION_AVAILABLE
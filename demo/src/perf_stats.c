@@ -0,0 +1,312 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LwM2M Object: Update Phase Timing
+ * ID: 26241, URN: N/A, Optional, Multiple
+ *
+ * Execution time statistics of the phases of the demo update loop, one
+ * instance per phase.
+ */
+#include <assert.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "perf_stats.h"
+
+/**
+ * Phase Name: R, Single, Mandatory
+ * type: string, range: N/A, unit: N/A
+ * Name of the measured phase.
+ */
+#define RID_PHASE_NAME 0
+
+/**
+ * Samples: R, Single, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ * Number of measurements since the last reset.
+ */
+#define RID_SAMPLES 1
+
+/**
+ * Median Duration: R, Single, Mandatory
+ * type: integer, range: N/A, unit: us
+ * Upper bound of the histogram bucket containing the 50th percentile.
+ */
+#define RID_P50_DURATION 2
+
+/**
+ * 99th Percentile Duration: R, Single, Mandatory
+ * type: integer, range: N/A, unit: us
+ * Upper bound of the histogram bucket containing the 99th percentile.
+ */
+#define RID_P99_DURATION 3
+
+/**
+ * Max Duration: R, Single, Mandatory
+ * type: integer, range: N/A, unit: us
+ * Longest measured duration since the last reset.
+ */
+#define RID_MAX_DURATION 4
+
+/**
+ * Reset: E, Single, Optional
+ * type: N/A, range: N/A, unit: N/A
+ * Resets statistics of all phases.
+ */
+#define RID_RESET 5
+
+// bucket N holds durations in range [2^N, 2^(N+1)) us, bucket 0 also holds 0 us
+#define HISTOGRAM_BUCKETS 20
+
+struct perf_histogram {
+	const char *phase;
+	uint32_t buckets[HISTOGRAM_BUCKETS];
+	uint32_t samples;
+	uint32_t max_us;
+};
+
+static struct perf_histogram histograms[PERF_STATS_MAX_PHASES];
+static size_t histograms_count;
+static struct k_spinlock lock;
+
+static struct perf_histogram *find_or_add_histogram(const char *phase)
+{
+	for (size_t i = 0; i < histograms_count; i++) {
+		if (histograms[i].phase == phase || !strcmp(histograms[i].phase, phase)) {
+			return &histograms[i];
+		}
+	}
+
+	if (histograms_count >= AVS_ARRAY_SIZE(histograms)) {
+		return NULL;
+	}
+
+	histograms[histograms_count].phase = phase;
+	return &histograms[histograms_count++];
+}
+
+static size_t bucket_index(uint32_t us)
+{
+	if (us < 2) {
+		return 0;
+	}
+
+	size_t index = 31 - __builtin_clz(us);
+
+	return MIN(index, HISTOGRAM_BUCKETS - 1);
+}
+
+static uint32_t percentile_us(const struct perf_histogram *histogram, uint32_t percent)
+{
+	if (!histogram->samples) {
+		return 0;
+	}
+
+	uint32_t target = DIV_ROUND_UP((uint64_t)histogram->samples * percent, 100);
+	uint32_t cumulative = 0;
+
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS - 1; i++) {
+		cumulative += histogram->buckets[i];
+		if (cumulative >= target) {
+			return MIN((UINT32_C(2) << i) - 1, histogram->max_us);
+		}
+	}
+	return histogram->max_us;
+}
+
+void perf_stats_register(const char *phase)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	find_or_add_histogram(phase);
+	k_spin_unlock(&lock, key);
+}
+
+void perf_stats_record(const char *phase, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct perf_histogram *histogram = find_or_add_histogram(phase);
+
+	if (histogram) {
+		histogram->buckets[bucket_index(us)]++;
+		histogram->samples++;
+		histogram->max_us = MAX(histogram->max_us, us);
+	}
+	k_spin_unlock(&lock, key);
+}
+
+void perf_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < histograms_count; i++) {
+		memset(histograms[i].buckets, 0, sizeof(histograms[i].buckets));
+		histograms[i].samples = 0;
+		histograms[i].max_us = 0;
+	}
+	k_spin_unlock(&lock, key);
+}
+
+static struct perf_histogram snapshot(size_t index)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct perf_histogram result = histograms[index];
+
+	k_spin_unlock(&lock, key);
+	return result;
+}
+
+static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+
+	for (size_t i = 0; i < histograms_count; i++) {
+		anjay_dm_emit(ctx, (anjay_iid_t)i);
+	}
+	return 0;
+}
+
+static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	anjay_dm_emit_res(ctx, RID_PHASE_NAME, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_SAMPLES, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_P50_DURATION, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_P99_DURATION, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_MAX_DURATION, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_RESET, ANJAY_DM_RES_E, ANJAY_DM_RES_PRESENT);
+	return 0;
+}
+
+static int resource_read(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			 anjay_iid_t iid, anjay_rid_t rid, anjay_riid_t riid,
+			 anjay_output_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)riid;
+
+	assert(iid < histograms_count);
+	struct perf_histogram histogram = snapshot(iid);
+
+	switch (rid) {
+	case RID_PHASE_NAME:
+		return anjay_ret_string(ctx, histogram.phase);
+
+	case RID_SAMPLES:
+		return anjay_ret_i64(ctx, histogram.samples);
+
+	case RID_P50_DURATION:
+		return anjay_ret_i64(ctx, percentile_us(&histogram, 50));
+
+	case RID_P99_DURATION:
+		return anjay_ret_i64(ctx, percentile_us(&histogram, 99));
+
+	case RID_MAX_DURATION:
+		return anjay_ret_i64(ctx, histogram.max_us);
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static int resource_execute(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			    anjay_iid_t iid, anjay_rid_t rid, anjay_execute_ctx_t *arg_ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+	(void)arg_ctx;
+
+	switch (rid) {
+	case RID_RESET:
+		perf_stats_reset();
+		return 0;
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static const anjay_dm_object_def_t OBJ_DEF = { .oid = 26241,
+					       .handlers = { .list_instances = list_instances,
+							     .list_resources = list_resources,
+							     .resource_read = resource_read,
+							     .resource_execute =
+								     resource_execute } };
+
+static const anjay_dm_object_def_t *obj_def_ptr = &OBJ_DEF;
+
+const anjay_dm_object_def_t **perf_stats_object_create(void)
+{
+	return &obj_def_ptr;
+}
+
+void perf_stats_object_release(const anjay_dm_object_def_t **def)
+{
+	(void)def;
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_perf_show(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	shell_print(sh, "%-12s %10s %10s %10s %10s", "phase", "samples", "p50 [us]", "p99 [us]",
+		    "max [us]");
+	for (size_t i = 0; i < histograms_count; i++) {
+		struct perf_histogram histogram = snapshot(i);
+
+		shell_print(sh, "%-12s %10u %10u %10u %10u", histogram.phase, histogram.samples,
+			    percentile_us(&histogram, 50), percentile_us(&histogram, 99),
+			    histogram.max_us);
+	}
+	return 0;
+}
+
+static int cmd_perf_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	perf_stats_reset();
+	shell_print(sh, "Statistics reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_perf,
+			       SHELL_CMD(show, NULL, "Show update phase timing statistics",
+					 cmd_perf_show),
+			       SHELL_CMD(reset, NULL, "Reset update phase timing statistics",
+					 cmd_perf_reset),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(perf, &sub_perf, "Update loop performance statistics", NULL);
+#endif // CONFIG_SHELL
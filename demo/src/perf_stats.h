@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+
+#include <anjay/dm.h>
+
+#ifdef CONFIG_APP_PERF_STATS
+
+#define PERF_STATS_MAX_PHASES 12
+
+/**
+ * Registers a phase with a given name, so that it is visible even before its
+ * first measurement. Measurements of unregistered phases register them
+ * implicitly.
+ */
+void perf_stats_register(const char *phase);
+
+void perf_stats_record(const char *phase, uint32_t cycles);
+
+void perf_stats_reset(void);
+
+const anjay_dm_object_def_t **perf_stats_object_create(void);
+void perf_stats_object_release(const anjay_dm_object_def_t **def);
+
+/**
+ * Executes @p Statement and records its execution time as @p Phase.
+ */
+#define PERF_STATS_TIMED(Phase, Statement)                                                         \
+	do {                                                                                       \
+		uint32_t _perf_stats_start = k_cycle_get_32();                                     \
+		Statement;                                                                         \
+		perf_stats_record((Phase), k_cycle_get_32() - _perf_stats_start);                  \
+	} while (0)
+
+#else // CONFIG_APP_PERF_STATS
+
+#define perf_stats_register(Phase) ((void)0)
+#define PERF_STATS_TIMED(Phase, Statement)                                                         \
+	do {                                                                                       \
+		Statement;                                                                         \
+	} while (0)
+
+#endif // CONFIG_APP_PERF_STATS
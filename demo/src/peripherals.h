@@ -18,6 +18,7 @@
 
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/util.h>
 
 #define RGB_NODE DT_ALIAS(rgb_pwm)
 #define LED_COLOR_LIGHT_AVAILABLE DT_NODE_HAS_STATUS(RGB_NODE, okay)
@@ -25,21 +26,32 @@
 #define BUZZER_NODE DT_ALIAS(buzzer_pwm)
 #define BUZZER_AVAILABLE DT_NODE_HAS_STATUS(BUZZER_NODE, okay)
 
+/**
+ * Numbered aliases (light-control-N, push-button-N, switch-N) are looked up for
+ * N from 0 up to this limit. Gaps in the numbering are allowed. The lookup is
+ * done entirely by the preprocessor, so the limit has no runtime cost.
+ */
+#define PERIPHERAL_ALIAS_INDEX_LIMIT 64
+
 #define LIGHT_CONTROL_NODE(idx) DT_ALIAS(light_control_##idx)
 #define LIGHT_CONTROL_AVAILABLE(idx) DT_NODE_HAS_STATUS(LIGHT_CONTROL_NODE(idx), okay)
-#define LIGHT_CONTROL_AVAILABLE_ANY                                                                \
-	(LIGHT_CONTROL_AVAILABLE(0) || LIGHT_CONTROL_AVAILABLE(1) || LIGHT_CONTROL_AVAILABLE(2) || \
-	 LIGHT_CONTROL_AVAILABLE(3))
+#define LIGHT_CONTROL_COUNT_ITEM(idx, ...) LIGHT_CONTROL_AVAILABLE(idx)
+#define LIGHT_CONTROL_COUNT (LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, LIGHT_CONTROL_COUNT_ITEM, (+)))
+#define LIGHT_CONTROL_AVAILABLE_ANY (LIGHT_CONTROL_COUNT > 0)
 
 #define PUSH_BUTTON_NODE(idx) DT_ALIAS(push_button_##idx)
 #define PUSH_BUTTON_AVAILABLE(idx) DT_NODE_HAS_STATUS(PUSH_BUTTON_NODE(idx), okay)
-#define PUSH_BUTTON_AVAILABLE_ANY                                                                  \
-	(PUSH_BUTTON_AVAILABLE(0) || PUSH_BUTTON_AVAILABLE(1) || PUSH_BUTTON_AVAILABLE(2) ||       \
-	 PUSH_BUTTON_AVAILABLE(3))
+#define PUSH_BUTTON_COUNT_ITEM(idx, ...) PUSH_BUTTON_AVAILABLE(idx)
+#define PUSH_BUTTON_COUNT (LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, PUSH_BUTTON_COUNT_ITEM, (+)))
+#define PUSH_BUTTON_AVAILABLE_ANY (PUSH_BUTTON_COUNT > 0)
 
 #define SWITCH_NODE(idx) DT_ALIAS(switch_##idx)
 #define SWITCH_AVAILABLE(idx) DT_NODE_HAS_STATUS(SWITCH_NODE(idx), okay)
-#define SWITCH_AVAILABLE_ANY (SWITCH_AVAILABLE(0) || SWITCH_AVAILABLE(1) || SWITCH_AVAILABLE(2))
+#define SWITCH_COUNT_ITEM(idx, ...) SWITCH_AVAILABLE(idx)
+#define SWITCH_COUNT (LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, SWITCH_COUNT_ITEM, (+)))
+#define SWITCH_AVAILABLE_ANY (SWITCH_COUNT > 0)
+
+#define LIGHT_CONTROL_GLUE_ITEM(num) GPIO_DT_SPEC_GET(LIGHT_CONTROL_NODE(num), gpios)
 
 #define PUSH_BUTTON_GLUE_ITEM(num)                                                                 \
 	{ .device = DEVICE_DT_GET(DT_GPIO_CTLR(PUSH_BUTTON_NODE(num), gpios)),                     \
@@ -51,6 +63,23 @@
 	  .gpio_pin = DT_GPIO_PIN(SWITCH_NODE(num), gpios),                                        \
 	  .gpio_flags = (GPIO_INPUT | DT_GPIO_FLAGS(SWITCH_NODE(num), gpios)) }
 
+// table entries (with the trailing comma) for the aliases that exist
+#define LIGHT_CONTROL_TABLE_ITEM(idx, ...)                                                         \
+	IF_ENABLED(LIGHT_CONTROL_AVAILABLE(idx), (LIGHT_CONTROL_GLUE_ITEM(idx), ))
+#define PUSH_BUTTON_TABLE_ITEM(idx, ...)                                                           \
+	IF_ENABLED(PUSH_BUTTON_AVAILABLE(idx), (PUSH_BUTTON_GLUE_ITEM(idx), ))
+#define SWITCH_TABLE_ITEM(idx, ...)                                                                \
+	IF_ENABLED(SWITCH_AVAILABLE(idx), (SWITCH_BUTTON_GLUE_ITEM(idx), ))
+
+#define LIGHT_CONTROL_TABLE LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, LIGHT_CONTROL_TABLE_ITEM, ())
+#define PUSH_BUTTON_TABLE LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, PUSH_BUTTON_TABLE_ITEM, ())
+#define SWITCH_TABLE LISTIFY(PERIPHERAL_ALIAS_INDEX_LIMIT, SWITCH_TABLE_ITEM, ())
+
+// names of the data-ready interrupt line properties used by the sensor bindings
+#define SENSOR_DRDY_AVAILABLE(node)                                                                \
+	(DT_NODE_HAS_PROP(node, drdy_gpios) || DT_NODE_HAS_PROP(node, irq_gpios) ||               \
+	 DT_NODE_HAS_PROP(node, int_gpios) || DT_NODE_HAS_PROP(node, int1_gpios))
+
 #define TEMPERATURE_NODE DT_ALIAS(temperature)
 #define TEMPERATURE_AVAILABLE DT_NODE_HAS_STATUS(TEMPERATURE_NODE, okay)
 
@@ -0,0 +1,327 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LwM2M Object: Runtime Metrics
+ * ID: 26244, URN: N/A, Optional, Single
+ *
+ * CPU, stack and heap usage of the device, sampled on each Read. Multiple
+ * resources have one instance per thread, with the same Resource Instance IDs
+ * across resources.
+ */
+#include <assert.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "runtime_metrics.h"
+
+/**
+ * Thread Name: R, Multiple, Mandatory
+ * type: string, range: N/A, unit: N/A
+ */
+#define RID_THREAD_NAME 0
+
+/**
+ * Thread CPU Share: R, Multiple, Mandatory
+ * type: float, range: 0..100, unit: %
+ * Share of the CPU time used by the thread since the previous sample.
+ */
+#define RID_THREAD_CPU_SHARE 1
+
+/**
+ * Stack Size: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_STACK_SIZE 2
+
+/**
+ * Stack Headroom: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ * Part of the stack of the thread that has never been used since the thread
+ * was started.
+ */
+#define RID_STACK_HEADROOM 3
+
+/**
+ * CPU Load: R, Single, Mandatory
+ * type: float, range: 0..100, unit: %
+ * Share of the CPU time not spent idle since the previous sample.
+ */
+#define RID_CPU_LOAD 4
+
+/**
+ * Heap Size: R, Single, Optional
+ * type: integer, range: N/A, unit: B
+ * Size of the k_malloc() heap.
+ */
+#define RID_HEAP_SIZE 5
+
+/**
+ * Heap Allocated: R, Single, Optional
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_HEAP_ALLOCATED 6
+
+/**
+ * Heap Peak: R, Single, Optional
+ * type: integer, range: N/A, unit: B
+ * The highest amount of memory allocated at once since boot.
+ */
+#define RID_HEAP_PEAK 7
+
+#define RUNTIME_METRICS_MAX_THREADS 24
+// a single Read of the whole object is served from one sample
+#define SAMPLE_MAX_AGE_MS 100
+
+#define HEAP_AVAILABLE (CONFIG_HEAP_MEM_POOL_SIZE > 0)
+
+struct thread_metrics {
+	// NULL if the slot is free
+	const struct k_thread *thread;
+	const char *name;
+	uint64_t execution_cycles;
+	float cpu_share;
+	size_t stack_size;
+	size_t stack_headroom;
+	bool seen;
+};
+
+static struct thread_metrics threads[RUNTIME_METRICS_MAX_THREADS];
+static uint64_t all_execution_cycles;
+static uint64_t all_busy_cycles;
+static uint64_t sampled_execution_cycles;
+static float cpu_load;
+static int64_t sample_timestamp_ms;
+static bool sampled;
+
+#if HEAP_AVAILABLE
+extern struct k_heap _system_heap;
+
+static struct sys_memory_stats heap_stats;
+#endif // HEAP_AVAILABLE
+
+static struct thread_metrics *get_thread_metrics(const struct k_thread *thread)
+{
+	struct thread_metrics *free_slot = NULL;
+
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(threads); i++) {
+		if (threads[i].thread == thread) {
+			return &threads[i];
+		}
+		if (!threads[i].thread && !free_slot) {
+			free_slot = &threads[i];
+		}
+	}
+
+	if (free_slot) {
+		memset(free_slot, 0, sizeof(*free_slot));
+		free_slot->thread = thread;
+	}
+	return free_slot;
+}
+
+static void sample_thread(const struct k_thread *thread, void *user_data)
+{
+	(void)user_data;
+
+	struct k_thread *mutable_thread = (struct k_thread *)thread;
+	struct thread_metrics *metrics = get_thread_metrics(thread);
+	k_thread_runtime_stats_t stats;
+	size_t unused;
+
+	if (!metrics) {
+		return;
+	}
+
+	metrics->seen = true;
+	metrics->name = k_thread_name_get(mutable_thread);
+	if (!k_thread_runtime_stats_get(mutable_thread, &stats)) {
+		// threads started since the previous sample have run only within it
+		uint64_t cycles = stats.execution_cycles - metrics->execution_cycles;
+
+		metrics->cpu_share = sampled_execution_cycles
+					     ? 100.0f * cycles / sampled_execution_cycles
+					     : 0.0f;
+		metrics->execution_cycles = stats.execution_cycles;
+	}
+	if (!k_thread_stack_space_get(thread, &unused)) {
+		metrics->stack_size = thread->stack_info.size;
+		metrics->stack_headroom = unused;
+	}
+}
+
+static void sample(void)
+{
+	if (sampled && k_uptime_get() - sample_timestamp_ms < SAMPLE_MAX_AGE_MS) {
+		return;
+	}
+
+	k_thread_runtime_stats_t all;
+
+	if (!k_thread_runtime_stats_all_get(&all)) {
+		uint64_t busy_cycles = all.total_cycles - all_busy_cycles;
+
+		sampled_execution_cycles = all.execution_cycles - all_execution_cycles;
+		cpu_load = sampled_execution_cycles
+				   ? 100.0f * busy_cycles / sampled_execution_cycles
+				   : 0.0f;
+		all_execution_cycles = all.execution_cycles;
+		all_busy_cycles = all.total_cycles;
+	}
+
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(threads); i++) {
+		threads[i].seen = false;
+	}
+	k_thread_foreach_unlocked(sample_thread, NULL);
+	// forget the threads that have exited
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(threads); i++) {
+		if (!threads[i].seen) {
+			threads[i].thread = NULL;
+		}
+	}
+
+#if HEAP_AVAILABLE
+	// only reads the statistics, so that the peak reflects real allocations
+	sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats);
+#endif // HEAP_AVAILABLE
+
+	sample_timestamp_ms = k_uptime_get();
+	sampled = true;
+}
+
+static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+
+	anjay_dm_emit(ctx, 0);
+	return 0;
+}
+
+static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	// called at the beginning of every operation on the object
+	sample();
+
+	anjay_dm_emit_res(ctx, RID_THREAD_NAME, ANJAY_DM_RES_RM, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_THREAD_CPU_SHARE, ANJAY_DM_RES_RM, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_STACK_SIZE, ANJAY_DM_RES_RM, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_STACK_HEADROOM, ANJAY_DM_RES_RM, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_CPU_LOAD, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+#if HEAP_AVAILABLE
+	anjay_dm_emit_res(ctx, RID_HEAP_SIZE, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_HEAP_ALLOCATED, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_HEAP_PEAK, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+#endif // HEAP_AVAILABLE
+	return 0;
+}
+
+static int list_resource_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+				   anjay_iid_t iid, anjay_rid_t rid, anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+	(void)rid;
+
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(threads); i++) {
+		if (threads[i].thread) {
+			anjay_dm_emit(ctx, (anjay_riid_t)i);
+		}
+	}
+	return 0;
+}
+
+static int resource_read(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			 anjay_iid_t iid, anjay_rid_t rid, anjay_riid_t riid,
+			 anjay_output_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	const struct thread_metrics *metrics = NULL;
+
+	if (rid <= RID_STACK_HEADROOM) {
+		assert(riid < AVS_ARRAY_SIZE(threads));
+		metrics = &threads[riid];
+		if (!metrics->thread) {
+			return ANJAY_ERR_NOT_FOUND;
+		}
+	}
+
+	switch (rid) {
+	case RID_THREAD_NAME:
+		return anjay_ret_string(ctx, metrics->name ? metrics->name : "");
+
+	case RID_THREAD_CPU_SHARE:
+		return anjay_ret_float(ctx, metrics->cpu_share);
+
+	case RID_STACK_SIZE:
+		return anjay_ret_i64(ctx, metrics->stack_size);
+
+	case RID_STACK_HEADROOM:
+		return anjay_ret_i64(ctx, metrics->stack_headroom);
+
+	case RID_CPU_LOAD:
+		return anjay_ret_float(ctx, cpu_load);
+
+#if HEAP_AVAILABLE
+	case RID_HEAP_SIZE:
+		return anjay_ret_i64(ctx, heap_stats.allocated_bytes + heap_stats.free_bytes);
+
+	case RID_HEAP_ALLOCATED:
+		return anjay_ret_i64(ctx, heap_stats.allocated_bytes);
+
+	case RID_HEAP_PEAK:
+		return anjay_ret_i64(ctx, heap_stats.max_allocated_bytes);
+#endif // HEAP_AVAILABLE
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static const anjay_dm_object_def_t OBJ_DEF = {
+	.oid = 26244,
+	.handlers = { .list_instances = list_instances,
+		      .list_resources = list_resources,
+		      .list_resource_instances = list_resource_instances,
+		      .resource_read = resource_read }
+};
+
+static const anjay_dm_object_def_t *obj_def_ptr = &OBJ_DEF;
+
+const anjay_dm_object_def_t **runtime_metrics_object_create(void)
+{
+	return &obj_def_ptr;
+}
+
+void runtime_metrics_object_release(const anjay_dm_object_def_t **def)
+{
+	(void)def;
+}
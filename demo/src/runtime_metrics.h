@@ -0,0 +1,34 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/dm.h>
+
+#ifdef CONFIG_APP_RUNTIME_METRICS
+
+/**
+ * Creates the Runtime Metrics (/26244) object, which reports the CPU share and
+ * stack headroom of every thread, and the usage of the k_malloc() heap.
+ * The metrics are sampled only when the object is read, which includes
+ * notifications of observations, so an unobserved object costs nothing.
+ *
+ * Depends only on Zephyr and Anjay, so that it can be used in any sample.
+ */
+const anjay_dm_object_def_t **runtime_metrics_object_create(void);
+void runtime_metrics_object_release(const anjay_dm_object_def_t **def);
+
+#endif // CONFIG_APP_RUNTIME_METRICS
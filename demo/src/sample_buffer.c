@@ -0,0 +1,353 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/logging/log.h>
+
+#include <anjay/lwm2m_send.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "flash_log.h"
+#include "sample_buffer.h"
+#include "update_scheduler.h"
+
+LOG_MODULE_REGISTER(sample_buffer);
+
+// anjay_zephyr always configures its LwM2M Server with this Short Server ID
+#define SEND_SSID 1
+
+static struct sample_record records[CONFIG_APP_SAMPLE_BUFFER_SIZE];
+// index of the oldest record
+static size_t records_head;
+static size_t records_count;
+// number of the oldest records in the Send that has not finished yet
+static size_t sending_count;
+static bool send_in_flight;
+// set while a failed flush waits to be retried, which reaching the high watermark does not hasten
+static bool flush_backing_off;
+static uint32_t dropped_count;
+
+static struct update_task flush_task;
+
+static avs_time_monotonic_t max_age_deadline(void)
+{
+	return avs_time_monotonic_add(
+		avs_time_monotonic_now(),
+		avs_time_duration_from_scalar(CONFIG_APP_SAMPLE_BUFFER_MAX_AGE_S, AVS_TIME_S));
+}
+
+static anjay_send_batch_t *compile_batch(const struct sample_record *ring, size_t ring_size,
+					 size_t head, size_t count)
+{
+	anjay_send_batch_builder_t *builder = anjay_send_batch_builder_new();
+
+	if (!builder) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const struct sample_record *record = &ring[(head + i) % ring_size];
+
+		if (anjay_send_batch_add_double(builder, record->oid, record->iid, record->rid,
+						ANJAY_ID_INVALID, record->timestamp,
+						record->value)) {
+			anjay_send_batch_builder_cleanup(&builder);
+			return NULL;
+		}
+	}
+
+	return anjay_send_batch_builder_compile(&builder);
+}
+
+#ifdef CONFIG_APP_FLASH_LOG
+static bool flash_log_ready;
+static struct update_task drain_task;
+static bool drain_in_flight;
+// log entries covered by the batch being sent
+static uint32_t drain_position;
+static size_t drain_span;
+static struct sample_record drain_records[CONFIG_APP_FLASH_LOG_BATCH_SIZE];
+
+static avs_time_monotonic_t drain_interval_deadline(void)
+{
+	return avs_time_monotonic_add(
+		avs_time_monotonic_now(),
+		avs_time_duration_from_scalar(CONFIG_APP_FLASH_LOG_DRAIN_INTERVAL_MS, AVS_TIME_MS));
+}
+
+static bool backlog_pending(void)
+{
+	return flash_log_ready && flash_log_count();
+}
+
+// moves the @p count oldest records to the flash log
+static int spill(size_t count)
+{
+	if (!flash_log_ready) {
+		return -1;
+	}
+
+	for (; count; count--) {
+		if (flash_log_append(&records[records_head])) {
+			return -1;
+		}
+		records_head = (records_head + 1) % AVS_ARRAY_SIZE(records);
+		records_count--;
+		if (sending_count) {
+			// if the Send succeeds after all, the record will be sent twice
+			sending_count--;
+		}
+	}
+
+	if (!drain_in_flight && !avs_time_monotonic_valid(drain_task.deadline)) {
+		update_scheduler_set_deadline(&drain_task, max_age_deadline());
+	}
+	return 0;
+}
+
+static void drain_finished(anjay_t *anjay, anjay_ssid_t ssid, const anjay_send_batch_t *batch,
+			   int result, void *data)
+{
+	(void)anjay;
+	(void)ssid;
+	(void)batch;
+	(void)data;
+
+	drain_in_flight = false;
+	if (result != ANJAY_SEND_SUCCESS) {
+		LOG_WRN("Could not upload the backlog (%d), retrying later", result);
+		update_scheduler_set_deadline(&drain_task, max_age_deadline());
+		return;
+	}
+
+	// records dropped from the log in the meantime are not consumed again
+	flash_log_consume(drain_position, drain_span);
+	LOG_DBG("Backlog batch delivered, %zu samples left", flash_log_count());
+	if (flash_log_count()) {
+		// rate limit, so that the backlog does not saturate the link
+		update_scheduler_set_deadline(&drain_task, drain_interval_deadline());
+	}
+}
+
+static void drain(anjay_t *anjay)
+{
+	if (drain_in_flight || !flash_log_count()) {
+		return;
+	}
+
+	size_t count = flash_log_read(drain_records, AVS_ARRAY_SIZE(drain_records), &drain_position,
+				      &drain_span);
+
+	if (!count) {
+		// only corrupted records
+		flash_log_consume(drain_position, drain_span);
+		update_scheduler_set_deadline(&drain_task, avs_time_monotonic_now());
+		return;
+	}
+
+	anjay_send_batch_t *batch = compile_batch(drain_records, count, 0, count);
+
+	if (!batch) {
+		LOG_ERR("Could not build a batch of %zu samples", count);
+		update_scheduler_set_deadline(&drain_task, max_age_deadline());
+		return;
+	}
+
+	// while the device is not registered, Anjay holds the batch until it is, so that the
+	// drain is not polled for the registration to finish
+	anjay_send_result_t result =
+		anjay_send_deferrable(anjay, SEND_SSID, batch, drain_finished, NULL);
+
+	anjay_send_batch_release(&batch);
+
+	if (result != ANJAY_SEND_OK) {
+		update_scheduler_set_deadline(&drain_task, max_age_deadline());
+		return;
+	}
+	drain_in_flight = true;
+}
+#else  // CONFIG_APP_FLASH_LOG
+static bool backlog_pending(void)
+{
+	return false;
+}
+
+static int spill(size_t count)
+{
+	(void)count;
+	return -1;
+}
+#endif // CONFIG_APP_FLASH_LOG
+
+static avs_time_monotonic_t flush_deadline(void)
+{
+	if (records_count >= CONFIG_APP_SAMPLE_BUFFER_HIGH_WATERMARK) {
+		return avs_time_monotonic_now();
+	}
+	return records_count ? max_age_deadline() : AVS_TIME_MONOTONIC_INVALID;
+}
+
+static void retry_flush_later(void)
+{
+	flush_backing_off = true;
+	update_scheduler_set_deadline(&flush_task, max_age_deadline());
+}
+
+static void send_finished(anjay_t *anjay, anjay_ssid_t ssid, const anjay_send_batch_t *batch,
+			  int result, void *data)
+{
+	(void)anjay;
+	(void)ssid;
+	(void)batch;
+	(void)data;
+
+	if (!send_in_flight) {
+		// the buffer has been reset by sample_buffer_start() in the meantime
+		return;
+	}
+
+	size_t count = sending_count;
+
+	send_in_flight = false;
+	sending_count = 0;
+
+	if (result == ANJAY_SEND_SUCCESS) {
+		LOG_DBG("Delivered %zu samples", count);
+		records_head = (records_head + count) % AVS_ARRAY_SIZE(records);
+		records_count -= count;
+	} else {
+		// e.g. a timeout, or the Send was aborted by a reconnection
+		LOG_WRN("Could not deliver %zu samples (%d)", count, result);
+		if (spill(count)) {
+			// kept in RAM and sent again, possibly with newer samples
+			retry_flush_later();
+			return;
+		}
+	}
+
+	update_scheduler_set_deadline(&flush_task, flush_deadline());
+}
+
+static void flush(anjay_t *anjay)
+{
+	flush_backing_off = false;
+	if (!records_count || send_in_flight) {
+		// in the latter case, send_finished() schedules the next flush
+		return;
+	}
+
+	if (backlog_pending()) {
+		// newer samples must not overtake the backlog
+		if (spill(records_count)) {
+			LOG_WRN("Could not store %zu samples, retrying later", records_count);
+			retry_flush_later();
+		}
+		return;
+	}
+
+	anjay_send_batch_t *batch =
+		compile_batch(records, AVS_ARRAY_SIZE(records), records_head, records_count);
+
+	if (!batch) {
+		LOG_ERR("Could not build a batch of %zu samples", records_count);
+		retry_flush_later();
+		return;
+	}
+
+	anjay_send_result_t result = anjay_send(anjay, SEND_SSID, batch, send_finished, NULL);
+
+	anjay_send_batch_release(&batch);
+
+	if (result != ANJAY_SEND_OK) {
+		LOG_WRN("Could not send %zu samples (%d), retrying later", records_count,
+			(int)result);
+		if (spill(records_count)) {
+			retry_flush_later();
+		}
+		return;
+	}
+
+	// the records are kept until the Send is delivered
+	LOG_DBG("Sending %zu samples", records_count);
+	sending_count = records_count;
+	send_in_flight = true;
+}
+
+void sample_buffer_add(anjay_oid_t oid, anjay_iid_t iid, anjay_rid_t rid, double value)
+{
+	if (records_count == AVS_ARRAY_SIZE(records) && spill(1)) {
+		// overwrite the oldest sample, which may be being sent
+		records_head = (records_head + 1) % AVS_ARRAY_SIZE(records);
+		records_count--;
+		dropped_count++;
+		if (sending_count) {
+			sending_count--;
+		}
+	}
+
+	records[(records_head + records_count++) % AVS_ARRAY_SIZE(records)] =
+		(struct sample_record){ .timestamp = avs_time_real_now(),
+					.value = value,
+					.oid = oid,
+					.iid = iid,
+					.rid = rid };
+
+	if (records_count >= CONFIG_APP_SAMPLE_BUFFER_HIGH_WATERMARK) {
+		// otherwise, send_finished() or the pending retry schedules the flush
+		if (!send_in_flight && !flush_backing_off) {
+			update_scheduler_set_deadline(&flush_task, avs_time_monotonic_now());
+		}
+	} else if (records_count == 1) {
+		update_scheduler_set_deadline(&flush_task, max_age_deadline());
+	}
+}
+
+int sample_buffer_start(void)
+{
+	flush_task = (struct update_task){ .name = "sample_buffer",
+					   .run = flush,
+					   .period = AVS_TIME_DURATION_INVALID };
+	// Sends are aborted when Anjay is destroyed, so this only matters if the
+	// abort has not been reported - the records are then sent again
+	send_in_flight = false;
+	sending_count = 0;
+	flush_backing_off = false;
+
+#ifdef CONFIG_APP_FLASH_LOG
+	static bool flash_log_mounted;
+
+	if (!flash_log_mounted) {
+		// on failure, samples that cannot be uploaded are dropped as before
+		flash_log_ready = !flash_log_init();
+		flash_log_mounted = true;
+	}
+
+	if (flash_log_ready) {
+		// the backlog left from before the restart is uploaded once registered
+		drain_in_flight = false;
+		drain_task = (struct update_task){ .name = "flash_log",
+						   .run = drain,
+						   .period = AVS_TIME_DURATION_INVALID };
+		update_scheduler_add(&drain_task);
+	}
+#endif // CONFIG_APP_FLASH_LOG
+
+	return update_scheduler_add(&flush_task);
+}
+
+uint32_t sample_buffer_dropped_count(void)
+{
+	return dropped_count;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_time.h>
+
+#ifdef CONFIG_APP_SAMPLE_BUFFER
+
+struct sample_record {
+	avs_time_real_t timestamp;
+	double value;
+	anjay_oid_t oid;
+	anjay_iid_t iid;
+	anjay_rid_t rid;
+};
+
+/**
+ * Stores a timestamped value of a resource. The buffer is uploaded with a
+ * single LwM2M Send message once it reaches the high watermark, or when its
+ * oldest sample reaches the maximum age. Samples are removed from the buffer
+ * only once the server has confirmed the delivery of the Send.
+ *
+ * If CONFIG_APP_FLASH_LOG is enabled, samples that could not be uploaded are
+ * moved to the flash log instead of being dropped, and the log is uploaded in
+ * batches, oldest first, before any newer samples.
+ */
+void sample_buffer_add(anjay_oid_t oid, anjay_iid_t iid, anjay_rid_t rid, double value);
+
+int sample_buffer_start(void);
+
+/**
+ * Returns the number of samples dropped since boot, because the buffer was
+ * full and could not be uploaded in time.
+ */
+uint32_t sample_buffer_dropped_count(void);
+
+#endif // CONFIG_APP_SAMPLE_BUFFER
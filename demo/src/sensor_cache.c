@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <avsystem/commons/avs_defs.h>
+
+#include "sensor_cache.h"
+#include "sensor_health.h"
+
+LOG_MODULE_REGISTER(sensor_cache);
+
+struct sensor_cache_entry {
+	const struct device *device;
+	uint32_t cycle;
+	int64_t fetch_timestamp;
+	int result;
+};
+
+static struct sensor_cache_entry entries[SENSOR_CACHE_MAX_DEVICES];
+static size_t entries_count;
+// starts at 1 so that zero-initialized entries are always stale
+static uint32_t current_cycle = 1;
+
+static struct sensor_cache_entry *get_entry(const struct device *device)
+{
+	for (size_t i = 0; i < entries_count; i++) {
+		if (entries[i].device == device) {
+			return &entries[i];
+		}
+	}
+
+	if (entries_count >= AVS_ARRAY_SIZE(entries)) {
+		return NULL;
+	}
+
+	struct sensor_cache_entry *entry = &entries[entries_count++];
+
+	entry->device = device;
+	return entry;
+}
+
+int sensor_cache_fetch(const struct device *device)
+{
+	struct sensor_cache_entry *entry = get_entry(device);
+
+	if (!entry) {
+		LOG_WRN("No cache entry left for %s", device->name);
+		return sensor_health_fetch(device);
+	}
+
+	if (entry->cycle == current_cycle &&
+	    k_uptime_get() - entry->fetch_timestamp <= CONFIG_APP_SENSOR_CACHE_MAX_AGE_MS) {
+		return entry->result;
+	}
+
+	entry->result = sensor_health_fetch(device);
+	entry->fetch_timestamp = k_uptime_get();
+	entry->cycle = current_cycle;
+
+	return entry->result;
+}
+
+int64_t sensor_cache_sample_timestamp(const struct device *device)
+{
+	for (size_t i = 0; i < entries_count; i++) {
+		if (entries[i].device == device) {
+			return entries[i].fetch_timestamp;
+		}
+	}
+	return -1;
+}
+
+void sensor_cache_new_cycle(void)
+{
+	current_cycle++;
+}
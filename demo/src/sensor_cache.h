@@ -0,0 +1,46 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zephyr/device.h>
+
+// there are 8 sensor aliases in peripherals.h, each may point to another device
+#define SENSOR_CACHE_MAX_DEVICES 8
+
+/**
+ * Fetches a sample of all channels of @p device, unless it has already been
+ * fetched in the current cycle and is not older than
+ * CONFIG_APP_SENSOR_CACHE_MAX_AGE_MS. Channels can be then read with
+ * sensor_channel_get() as usual.
+ *
+ * @returns 0 on success, or the error code of the fetch that has been cached.
+ */
+int sensor_cache_fetch(const struct device *device);
+
+/**
+ * Returns the uptime at which the sample returned by the last
+ * sensor_cache_fetch() of @p device was fetched, so that callers can tell a
+ * new sample from a cached one, or -1 if that is not known.
+ */
+int64_t sensor_cache_sample_timestamp(const struct device *device);
+
+/**
+ * Starts a new cycle - every device is fetched again on its next access.
+ */
+void sensor_cache_new_cycle(void);
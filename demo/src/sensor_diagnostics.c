@@ -0,0 +1,299 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LwM2M Object: Sensor Diagnostics
+ * ID: 26242, URN: N/A, Optional, Multiple
+ *
+ * Diagnostic information about the IPSO sensors installed by the demo, one
+ * instance per sensor.
+ */
+#include <assert.h>
+
+#include <anjay/anjay.h>
+
+#include "sensor_diagnostics.h"
+#include "sensor_health.h"
+#include "sensors.h"
+#include "update_scheduler.h"
+
+/**
+ * Sensor Object ID: R, Single, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ * Object ID of the IPSO sensor this instance refers to.
+ */
+#define RID_SENSOR_OBJECT_ID 0
+
+/**
+ * Sensor Instance ID: R, Single, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ * Instance ID of the IPSO sensor this instance refers to.
+ */
+#define RID_SENSOR_INSTANCE_ID 1
+
+/**
+ * Sensor Name: R, Single, Mandatory
+ * type: string, range: N/A, unit: N/A
+ * Human-readable name of the sensor.
+ */
+#define RID_SENSOR_NAME 2
+
+/**
+ * Suppressed Notifications: R, Single, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ * Number of value changes that were not reported, because they did not
+ * exceed the deadband of the sensor.
+ */
+#define RID_SUPPRESSED_NOTIFICATIONS 3
+
+/**
+ * Window Sample Count: R, Single, Optional
+ * type: integer, range: N/A, unit: N/A
+ * Number of samples aggregated in the last completed statistics window.
+ */
+#define RID_WINDOW_SAMPLE_COUNT 4
+
+/**
+ * Window Minimum: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * The lowest value sampled in the last completed statistics window, in the
+ * unit of the sensor. For three-axis sensors, this and the following
+ * resources refer to the magnitude of the measured vector.
+ */
+#define RID_WINDOW_MIN 5
+
+/**
+ * Window Maximum: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * The highest value sampled in the last completed statistics window.
+ */
+#define RID_WINDOW_MAX 6
+
+/**
+ * Window Mean: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * Mean of the values sampled in the last completed statistics window.
+ */
+#define RID_WINDOW_MEAN 7
+
+/**
+ * Window Standard Deviation: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * Sample standard deviation of the values sampled in the last completed
+ * statistics window.
+ */
+#define RID_WINDOW_STDDEV 8
+
+/**
+ * Fetch Errors: R, Single, Optional
+ * type: integer, range: N/A, unit: N/A
+ * Number of failed fetches from the device of the sensor. The device may be
+ * shared with other sensors, and so are this and the following resources.
+ */
+#define RID_FETCH_ERRORS 9
+
+/**
+ * Consecutive Failures: R, Single, Optional
+ * type: integer, range: N/A, unit: N/A
+ * Number of fetches that failed since the last successful one.
+ */
+#define RID_CONSECUTIVE_FAILURES 10
+
+/**
+ * Max Fetch Latency: R, Single, Optional
+ * type: integer, range: N/A, unit: us
+ * The longest time a fetch from the device took.
+ */
+#define RID_MAX_FETCH_LATENCY 11
+
+/**
+ * Mean Fetch Latency: R, Single, Optional
+ * type: integer, range: N/A, unit: us
+ * Mean time a fetch from the device took.
+ */
+#define RID_MEAN_FETCH_LATENCY 12
+
+/**
+ * Breaker Trips: R, Single, Optional
+ * type: integer, range: N/A, unit: N/A
+ * Number of times the device was paused after consecutive failures.
+ */
+#define RID_BREAKER_TRIPS 13
+
+/**
+ * Breaker Open: R, Single, Optional
+ * type: boolean, range: N/A, unit: N/A
+ * True if the device is currently paused and only probed in the background.
+ */
+#define RID_BREAKER_OPEN 14
+
+static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+
+	for (size_t i = 0; i < sensors_installed_count(); i++) {
+		// sensors whose devices turned out not to be ready are removed
+		if (!sensors_installed_get(i)->installed) {
+			continue;
+		}
+		anjay_dm_emit(ctx, (anjay_iid_t)i);
+	}
+	return 0;
+}
+
+static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	anjay_dm_emit_res(ctx, RID_SENSOR_OBJECT_ID, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_SENSOR_INSTANCE_ID, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_SENSOR_NAME, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_SUPPRESSED_NOTIFICATIONS, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+#ifdef CONFIG_APP_SENSOR_STATS
+	anjay_dm_resource_presence_t stats_presence =
+		sensors_installed_get(iid)->last_window.count ? ANJAY_DM_RES_PRESENT
+							      : ANJAY_DM_RES_ABSENT;
+
+	anjay_dm_emit_res(ctx, RID_WINDOW_SAMPLE_COUNT, ANJAY_DM_RES_R, ANJAY_DM_RES_PRESENT);
+	anjay_dm_emit_res(ctx, RID_WINDOW_MIN, ANJAY_DM_RES_R, stats_presence);
+	anjay_dm_emit_res(ctx, RID_WINDOW_MAX, ANJAY_DM_RES_R, stats_presence);
+	anjay_dm_emit_res(ctx, RID_WINDOW_MEAN, ANJAY_DM_RES_R, stats_presence);
+	anjay_dm_emit_res(ctx, RID_WINDOW_STDDEV, ANJAY_DM_RES_R, stats_presence);
+#endif // CONFIG_APP_SENSOR_STATS
+
+	struct sensor_health_stats health = { 0 };
+	// devices that have never been fetched have no statistics yet
+	anjay_dm_resource_presence_t health_presence =
+		sensor_health_get(sensors_installed_get(iid)->device, &health)
+			? ANJAY_DM_RES_ABSENT
+			: ANJAY_DM_RES_PRESENT;
+
+	anjay_dm_emit_res(ctx, RID_FETCH_ERRORS, ANJAY_DM_RES_R, health_presence);
+	anjay_dm_emit_res(ctx, RID_CONSECUTIVE_FAILURES, ANJAY_DM_RES_R, health_presence);
+	anjay_dm_emit_res(ctx, RID_MAX_FETCH_LATENCY, ANJAY_DM_RES_R, health_presence);
+	anjay_dm_emit_res(ctx, RID_MEAN_FETCH_LATENCY, ANJAY_DM_RES_R, health_presence);
+	anjay_dm_emit_res(ctx, RID_BREAKER_TRIPS, ANJAY_DM_RES_R, health_presence);
+	anjay_dm_emit_res(ctx, RID_BREAKER_OPEN, ANJAY_DM_RES_R, health_presence);
+	return 0;
+}
+
+static int resource_read(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			 anjay_iid_t iid, anjay_rid_t rid, anjay_riid_t riid,
+			 anjay_output_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)riid;
+
+	const struct sensor_context *sensor = sensors_installed_get(iid);
+	struct sensor_health_stats health = { 0 };
+
+	assert(sensor);
+
+	if (rid >= RID_FETCH_ERRORS && sensor_health_get(sensor->device, &health)) {
+		return ANJAY_ERR_NOT_FOUND;
+	}
+
+	switch (rid) {
+	case RID_SENSOR_OBJECT_ID:
+		return anjay_ret_i32(ctx, sensor->oid);
+
+	case RID_SENSOR_INSTANCE_ID:
+		return anjay_ret_i32(ctx, sensor->iid);
+
+	case RID_SENSOR_NAME:
+		return anjay_ret_string(ctx, sensor->name);
+
+	case RID_SUPPRESSED_NOTIFICATIONS:
+		return anjay_ret_i64(ctx, sensor->suppressed_notifications);
+
+#ifdef CONFIG_APP_SENSOR_STATS
+	case RID_WINDOW_SAMPLE_COUNT:
+		return anjay_ret_i64(ctx, sensor->last_window.count);
+
+	case RID_WINDOW_MIN:
+		return anjay_ret_double(ctx, sensor->last_window.min);
+
+	case RID_WINDOW_MAX:
+		return anjay_ret_double(ctx, sensor->last_window.max);
+
+	case RID_WINDOW_MEAN:
+		return anjay_ret_double(ctx, sensor->last_window.mean);
+
+	case RID_WINDOW_STDDEV:
+		return anjay_ret_double(ctx, sensor_window_stats_stddev(&sensor->last_window));
+#endif // CONFIG_APP_SENSOR_STATS
+
+	case RID_FETCH_ERRORS:
+		return anjay_ret_i64(ctx, health.errors);
+
+	case RID_CONSECUTIVE_FAILURES:
+		return anjay_ret_i64(ctx, health.consecutive_failures);
+
+	case RID_MAX_FETCH_LATENCY:
+		return anjay_ret_i64(ctx, health.max_latency_us);
+
+	case RID_MEAN_FETCH_LATENCY:
+		return anjay_ret_i64(ctx, sensor_health_mean_latency_us(&health));
+
+	case RID_BREAKER_TRIPS:
+		return anjay_ret_i64(ctx, health.breaker_trips);
+
+	case RID_BREAKER_OPEN:
+		return anjay_ret_bool(ctx, health.breaker_open);
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static const anjay_dm_object_def_t OBJ_DEF = { .oid = 26242,
+					       .handlers = { .list_instances = list_instances,
+							     .list_resources = list_resources,
+							     .resource_read = resource_read } };
+
+static const anjay_dm_object_def_t *obj_def_ptr = &OBJ_DEF;
+
+#ifdef CONFIG_APP_SENSOR_STATS
+void sensor_diagnostics_notify_stats(anjay_t *anjay, const struct sensor_context *sensor)
+{
+	for (size_t i = 0; i < sensors_installed_count(); i++) {
+		if (sensors_installed_get(i) != sensor) {
+			continue;
+		}
+		for (anjay_rid_t rid = RID_WINDOW_SAMPLE_COUNT; rid <= RID_WINDOW_STDDEV; rid++) {
+			update_scheduler_notify_changed(anjay, OBJ_DEF.oid, (anjay_iid_t)i, rid,
+							false);
+		}
+		return;
+	}
+}
+#endif // CONFIG_APP_SENSOR_STATS
+
+const anjay_dm_object_def_t **sensor_diagnostics_object_create(void)
+{
+	return &obj_def_ptr;
+}
+
+void sensor_diagnostics_object_release(const anjay_dm_object_def_t **def)
+{
+	(void)def;
+}
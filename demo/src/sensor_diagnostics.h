@@ -0,0 +1,32 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/dm.h>
+
+struct sensor_context;
+
+const anjay_dm_object_def_t **sensor_diagnostics_object_create(void);
+void sensor_diagnostics_object_release(const anjay_dm_object_def_t **def);
+
+#ifdef CONFIG_APP_SENSOR_STATS
+/**
+ * Notifies Anjay about new values of the window statistics resources of the
+ * instance that refers to @p sensor.
+ */
+void sensor_diagnostics_notify_stats(anjay_t *anjay, const struct sensor_context *sensor);
+#endif // CONFIG_APP_SENSOR_STATS
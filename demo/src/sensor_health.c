@@ -0,0 +1,264 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+#include <avsystem/commons/avs_defs.h>
+
+#include "sensor_health.h"
+
+LOG_MODULE_REGISTER(sensor_health);
+
+struct sensor_health_entry {
+	const struct device *device;
+	struct k_spinlock lock;
+	struct sensor_health_stats stats;
+#ifdef CONFIG_APP_SENSOR_BREAKER
+	uint32_t cooldown_ms;
+	struct k_work_delayable probe_work;
+#endif // CONFIG_APP_SENSOR_BREAKER
+};
+
+// fetches may happen on the Anjay thread, the sensor hub thread and in triggers
+static struct k_spinlock entries_lock;
+static struct sensor_health_entry entries[SENSOR_HEALTH_MAX_DEVICES];
+static size_t entries_count;
+
+#ifdef CONFIG_APP_SENSOR_BREAKER
+// probes may block on a misbehaving bus, so they are kept off the system work queue
+static struct k_work_q *probe_work_q;
+
+static void probe_work_handler(struct k_work *work);
+
+static void schedule_probe(struct sensor_health_entry *entry, uint32_t cooldown_ms)
+{
+	if (!probe_work_q) {
+		LOG_ERR("Cannot probe %s: no work queue", entry->device->name);
+		return;
+	}
+	k_work_schedule_for_queue(probe_work_q, &entry->probe_work, K_MSEC(cooldown_ms));
+}
+#endif // CONFIG_APP_SENSOR_BREAKER
+
+static struct sensor_health_entry *find_entry(const struct device *device)
+{
+	for (size_t i = 0; i < entries_count; i++) {
+		if (entries[i].device == device) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+static struct sensor_health_entry *get_entry(const struct device *device)
+{
+	k_spinlock_key_t key = k_spin_lock(&entries_lock);
+	struct sensor_health_entry *entry = find_entry(device);
+
+	if (!entry && entries_count < AVS_ARRAY_SIZE(entries)) {
+		entry = &entries[entries_count++];
+		entry->device = device;
+#ifdef CONFIG_APP_SENSOR_BREAKER
+		entry->cooldown_ms = CONFIG_APP_SENSOR_BREAKER_COOLDOWN_MS;
+		k_work_init_delayable(&entry->probe_work, probe_work_handler);
+#endif // CONFIG_APP_SENSOR_BREAKER
+	}
+	k_spin_unlock(&entries_lock, key);
+
+	return entry;
+}
+
+static void record_result(struct sensor_health_entry *entry, int err, uint32_t latency_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&entry->lock);
+	struct sensor_health_stats *stats = &entry->stats;
+
+	stats->fetches++;
+	stats->total_latency_us += latency_us;
+	stats->max_latency_us = MAX(stats->max_latency_us, latency_us);
+
+	if (!err) {
+		stats->consecutive_failures = 0;
+#ifdef CONFIG_APP_SENSOR_BREAKER
+		if (stats->breaker_open) {
+			stats->breaker_open = false;
+			entry->cooldown_ms = CONFIG_APP_SENSOR_BREAKER_COOLDOWN_MS;
+			k_spin_unlock(&entry->lock, key);
+			LOG_INF("%s recovered", entry->device->name);
+			return;
+		}
+#endif // CONFIG_APP_SENSOR_BREAKER
+		k_spin_unlock(&entry->lock, key);
+		return;
+	}
+
+	stats->errors++;
+	stats->consecutive_failures++;
+
+#ifdef CONFIG_APP_SENSOR_BREAKER
+	if (!stats->breaker_open &&
+	    stats->consecutive_failures >= CONFIG_APP_SENSOR_BREAKER_THRESHOLD) {
+		uint32_t cooldown_ms = entry->cooldown_ms;
+
+		stats->breaker_open = true;
+		stats->breaker_trips++;
+		k_spin_unlock(&entry->lock, key);
+
+		LOG_WRN("%s failed %u times in a row (%d), pausing it for %u ms",
+			entry->device->name, CONFIG_APP_SENSOR_BREAKER_THRESHOLD, err, cooldown_ms);
+		schedule_probe(entry, cooldown_ms);
+		return;
+	}
+#endif // CONFIG_APP_SENSOR_BREAKER
+	k_spin_unlock(&entry->lock, key);
+}
+
+static int timed_fetch(struct sensor_health_entry *entry)
+{
+	uint32_t start = k_cycle_get_32();
+	int err = sensor_sample_fetch(entry->device);
+
+	record_result(entry, err, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	return err;
+}
+
+#ifdef CONFIG_APP_SENSOR_BREAKER
+static void probe_work_handler(struct k_work *work)
+{
+	struct sensor_health_entry *entry = CONTAINER_OF(k_work_delayable_from_work(work),
+							 struct sensor_health_entry, probe_work);
+
+	if (!timed_fetch(entry)) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&entry->lock);
+
+	entry->cooldown_ms =
+		MIN(2 * entry->cooldown_ms, CONFIG_APP_SENSOR_BREAKER_MAX_COOLDOWN_S * 1000U);
+
+	uint32_t cooldown_ms = entry->cooldown_ms;
+
+	k_spin_unlock(&entry->lock, key);
+
+	LOG_DBG("Probe of %s failed, next one in %u ms", entry->device->name, cooldown_ms);
+	schedule_probe(entry, cooldown_ms);
+}
+#endif // CONFIG_APP_SENSOR_BREAKER
+
+void sensor_health_init(struct k_work_q *work_q)
+{
+#ifdef CONFIG_APP_SENSOR_BREAKER
+	probe_work_q = work_q;
+#else  // CONFIG_APP_SENSOR_BREAKER
+	(void)work_q;
+#endif // CONFIG_APP_SENSOR_BREAKER
+}
+
+int sensor_health_fetch(const struct device *device)
+{
+	struct sensor_health_entry *entry = get_entry(device);
+
+	if (!entry) {
+		return sensor_sample_fetch(device);
+	}
+
+#ifdef CONFIG_APP_SENSOR_BREAKER
+	k_spinlock_key_t key = k_spin_lock(&entry->lock);
+	bool breaker_open = entry->stats.breaker_open;
+
+	k_spin_unlock(&entry->lock, key);
+
+	if (breaker_open) {
+		return -EAGAIN;
+	}
+#endif // CONFIG_APP_SENSOR_BREAKER
+
+	return timed_fetch(entry);
+}
+
+void sensor_health_record(const struct device *device, int result, uint32_t latency_us)
+{
+	struct sensor_health_entry *entry = get_entry(device);
+
+	if (entry) {
+		record_result(entry, result, latency_us);
+	}
+}
+
+bool sensor_health_paused(const struct device *device)
+{
+	struct sensor_health_stats stats;
+
+	return !sensor_health_get(device, &stats) && stats.breaker_open;
+}
+
+int sensor_health_get(const struct device *device, struct sensor_health_stats *out_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&entries_lock);
+	struct sensor_health_entry *entry = find_entry(device);
+
+	k_spin_unlock(&entries_lock, key);
+
+	if (!entry) {
+		return -ENOENT;
+	}
+
+	key = k_spin_lock(&entry->lock);
+	*out_stats = entry->stats;
+	k_spin_unlock(&entry->lock, key);
+	return 0;
+}
+
+uint32_t sensor_health_mean_latency_us(const struct sensor_health_stats *stats)
+{
+	return stats->fetches ? (uint32_t)(stats->total_latency_us / stats->fetches) : 0;
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_sensor_health(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	shell_print(sh, "%-16s %8s %8s %8s %10s %10s %6s %s", "device", "fetches", "errors",
+		    "in row", "mean [us]", "max [us]", "trips", "state");
+
+	k_spinlock_key_t key = k_spin_lock(&entries_lock);
+	size_t count = entries_count;
+
+	k_spin_unlock(&entries_lock, key);
+
+	for (size_t i = 0; i < count; i++) {
+		struct sensor_health_stats stats;
+
+		sensor_health_get(entries[i].device, &stats);
+		shell_print(sh, "%-16s %8u %8u %8u %10u %10u %6u %s", entries[i].device->name,
+			    stats.fetches, stats.errors, stats.consecutive_failures,
+			    sensor_health_mean_latency_us(&stats), stats.max_latency_us,
+			    stats.breaker_trips, stats.breaker_open ? "open" : "closed");
+	}
+	return 0;
+}
+
+SHELL_CMD_REGISTER(sensor_health, NULL, "Show sensor fetch latency and error statistics",
+		   cmd_sensor_health);
+#endif // CONFIG_SHELL
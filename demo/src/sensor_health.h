@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+// there are 8 sensor aliases in peripherals.h, each may point to another device
+#define SENSOR_HEALTH_MAX_DEVICES 8
+
+struct sensor_health_stats {
+	uint32_t fetches;
+	uint32_t errors;
+	uint32_t consecutive_failures;
+	uint32_t max_latency_us;
+	uint64_t total_latency_us;
+	uint32_t breaker_trips;
+	bool breaker_open;
+};
+
+/**
+ * Sets the work queue on which devices with an open circuit breaker are
+ * probed. Must be called before the first fetch. The probes call the blocking
+ * sensor_sample_fetch(), so this should not be the system work queue.
+ */
+void sensor_health_init(struct k_work_q *work_q);
+
+/**
+ * Fetches a sample of all channels of @p device with sensor_sample_fetch(),
+ * accounting the latency and the result of the fetch.
+ *
+ * If CONFIG_APP_SENSOR_BREAKER is enabled, the circuit breaker of the device
+ * opens after CONFIG_APP_SENSOR_BREAKER_THRESHOLD consecutive failures. While
+ * it is open, this function fails immediately with -EAGAIN and the device is
+ * probed on the work queue passed to sensor_health_init() after a cool-down,
+ * which doubles after each failed probe. The breaker closes after the first
+ * successful fetch.
+ */
+int sensor_health_fetch(const struct device *device);
+
+/**
+ * Accounts a fetch of @p device that was performed by other means than
+ * sensor_health_fetch(), e.g. an asynchronous read.
+ */
+void sensor_health_record(const struct device *device, int result, uint32_t latency_us);
+
+/**
+ * @returns true if the circuit breaker of @p device is open, i.e. the device
+ *          should not be accessed.
+ */
+bool sensor_health_paused(const struct device *device);
+
+/**
+ * @returns 0 on success, or -ENOENT if @p device has never been fetched.
+ */
+int sensor_health_get(const struct device *device, struct sensor_health_stats *out_stats);
+
+uint32_t sensor_health_mean_latency_us(const struct sensor_health_stats *stats);
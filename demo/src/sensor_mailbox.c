@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <avsystem/commons/avs_defs.h>
+
+#include "sensor_mailbox.h"
+
+#define MIDDLE_FRESH 0x4
+#define MIDDLE_INDEX_MASK 0x3
+
+void sensor_mailbox_init(struct sensor_mailbox *mailbox)
+{
+	memset(mailbox, 0, sizeof(*mailbox));
+	mailbox->back = 0;
+	atomic_set(&mailbox->middle, 1);
+	mailbox->front = 2;
+}
+
+void sensor_mailbox_publish(struct sensor_mailbox *mailbox, const double *values,
+			    int64_t timestamp_ms)
+{
+	memcpy(mailbox->latest[mailbox->back], values, sizeof(mailbox->latest[0]));
+	mailbox->latest_timestamps_ms[mailbox->back] = timestamp_ms;
+	mailbox->back = (uint8_t)(atomic_set(&mailbox->middle, mailbox->back | MIDDLE_FRESH) &
+				  MIDDLE_INDEX_MASK);
+
+	uint32_t tail = (uint32_t)atomic_get(&mailbox->queue_tail);
+
+	if (tail - (uint32_t)atomic_get(&mailbox->queue_head) >= AVS_ARRAY_SIZE(mailbox->queue)) {
+		atomic_inc(&mailbox->dropped);
+		return;
+	}
+
+	memcpy(mailbox->queue[tail % AVS_ARRAY_SIZE(mailbox->queue)], values,
+	       sizeof(mailbox->queue[0]));
+	// makes the slot visible to the consumer
+	atomic_set(&mailbox->queue_tail, (atomic_val_t)(tail + 1));
+}
+
+int sensor_mailbox_latest(struct sensor_mailbox *mailbox, double *out_values,
+			  int64_t *out_timestamp_ms)
+{
+	if (atomic_get(&mailbox->middle) & MIDDLE_FRESH) {
+		mailbox->front =
+			(uint8_t)(atomic_set(&mailbox->middle, mailbox->front) & MIDDLE_INDEX_MASK);
+		mailbox->has_latest = true;
+	}
+
+	if (!mailbox->has_latest) {
+		return -1;
+	}
+
+	memcpy(out_values, mailbox->latest[mailbox->front], sizeof(mailbox->latest[0]));
+	if (out_timestamp_ms) {
+		*out_timestamp_ms = mailbox->latest_timestamps_ms[mailbox->front];
+	}
+	return 0;
+}
+
+bool sensor_mailbox_pop(struct sensor_mailbox *mailbox, double *out_values)
+{
+	uint32_t head = (uint32_t)atomic_get(&mailbox->queue_head);
+
+	if (head == (uint32_t)atomic_get(&mailbox->queue_tail)) {
+		return false;
+	}
+
+	memcpy(out_values, mailbox->queue[head % AVS_ARRAY_SIZE(mailbox->queue)],
+	       sizeof(mailbox->queue[0]));
+	atomic_set(&mailbox->queue_head, (atomic_val_t)(head + 1));
+	return true;
+}
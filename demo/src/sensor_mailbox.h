@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/sys/atomic.h>
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+
+#define SENSOR_MAILBOX_VALUES 3
+
+/**
+ * Lock-free mailbox passing samples of a sensor from a single producer (the
+ * sensor hub thread or a data-ready trigger handler) to a single consumer (the
+ * Anjay thread). The newest sample is exchanged through a triple buffer, so
+ * neither side ever waits for the other. Additionally, samples are queued for
+ * consumers that need every one of them; samples that do not fit in the queue
+ * are dropped from it, but are still available as the newest one.
+ */
+struct sensor_mailbox {
+	double latest[3][SENSOR_MAILBOX_VALUES];
+	// uptime at which each of the latest samples was taken
+	int64_t latest_timestamps_ms[3];
+	// index of the middle buffer, ORed with a flag if it holds an unseen sample
+	atomic_t middle;
+	// owned by the producer
+	uint8_t back;
+	// owned by the consumer
+	uint8_t front;
+	bool has_latest;
+
+	double queue[CONFIG_APP_SENSOR_MAILBOX_SIZE][SENSOR_MAILBOX_VALUES];
+	// free-running indices, written only by the consumer and the producer
+	atomic_t queue_head;
+	atomic_t queue_tail;
+	atomic_t dropped;
+};
+
+void sensor_mailbox_init(struct sensor_mailbox *mailbox);
+
+/**
+ * To be called only by the producer.
+ *
+ * @param timestamp_ms Uptime at which the sample was taken.
+ */
+void sensor_mailbox_publish(struct sensor_mailbox *mailbox, const double *values,
+			    int64_t timestamp_ms);
+
+/**
+ * Returns the newest published sample, to be called only by the consumer.
+ *
+ * @param out_timestamp_ms If not NULL, set to the uptime at which the sample
+ *                         was taken.
+ *
+ * @returns 0 on success, or -1 if nothing has been published yet.
+ */
+int sensor_mailbox_latest(struct sensor_mailbox *mailbox, double *out_values,
+			  int64_t *out_timestamp_ms);
+
+/**
+ * Takes the oldest queued sample, to be called only by the consumer.
+ */
+bool sensor_mailbox_pop(struct sensor_mailbox *mailbox, double *out_values);
+
+#endif // CONFIG_APP_SENSOR_MAILBOX
@@ -0,0 +1,333 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <math.h>
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/version.h>
+
+#include <avsystem/commons/avs_defs.h>
+
+#include "peripherals.h"
+#include "sensor_rtio.h"
+#include "sensors.h"
+
+LOG_MODULE_REGISTER(sensor_rtio);
+
+// channels of read I/O devices are plain enums before sensor_chan_spec
+#if KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+#define RTIO_CHANNEL_TYPE struct sensor_chan_spec
+#define RTIO_CHANNEL(chan) { (chan), 0 }
+#else // KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+#define RTIO_CHANNEL_TYPE enum sensor_channel
+#define RTIO_CHANNEL(chan) (chan)
+#endif // KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+
+// every device from sensors_config.c may be read in a single batch
+#define RTIO_QUEUE_SIZE SENSORS_MAX_INSTALLED
+// at most that many sensors of sensors_config.c share a device, e.g. BME680
+#define RTIO_CHANNELS_MAX 4
+// enough for a frame of all channels of a device, split into blocks
+#define RTIO_BLOCK_SIZE 16
+#define RTIO_BLOCKS_PER_READ 8
+// how often the completion queue is checked while waiting for a read
+#define CQE_POLL_PERIOD_MS 1
+
+/**
+ * One read I/O device per alias from peripherals.h, with the same channel as
+ * the corresponding sensor in sensors_config.c.
+ */
+#define RTIO_SOURCES(X)                                                                            \
+	X(temperature, TEMPERATURE_NODE, SENSOR_CHAN_AMBIENT_TEMP)                                 \
+	X(humidity, HUMIDITY_NODE, SENSOR_CHAN_HUMIDITY)                                           \
+	X(barometer, BAROMETER_NODE, SENSOR_CHAN_PRESS)                                            \
+	X(distance, DISTANCE_NODE, SENSOR_CHAN_DISTANCE)                                           \
+	X(illuminance, ILLUMINANCE_NODE, SENSOR_CHAN_LIGHT)                                        \
+	X(accelerometer, ACCELEROMETER_NODE, SENSOR_CHAN_ACCEL_XYZ)                                \
+	X(gyrometer, GYROMETER_NODE, SENSOR_CHAN_GYRO_XYZ)                                         \
+	X(magnetometer, MAGNETOMETER_NODE, SENSOR_CHAN_MAGN_XYZ)
+
+#define RTIO_CHANNEL_SLOT(index, chan) RTIO_CHANNEL(chan)
+
+/**
+ * Room for RTIO_CHANNELS_MAX channels, so that the I/O device can be
+ * reconfigured to read all channels of a device shared by several sensors.
+ */
+#define RTIO_SOURCE_IODEV(name, node, chan)                                                        \
+	COND_CODE_1(DT_NODE_HAS_STATUS(node, okay),                                                \
+		    (SENSOR_DT_READ_IODEV(name##_iodev, node,                                      \
+					  LISTIFY(RTIO_CHANNELS_MAX, RTIO_CHANNEL_SLOT, (,), chan));), \
+		    ())
+
+#define RTIO_SOURCE_ITEM(name, node, chan)                                                         \
+	COND_CODE_1(DT_NODE_HAS_STATUS(node, okay),                                                \
+		    ({ .device = DEVICE_DT_GET(node), .channel = chan, .iodev = &name##_iodev },), \
+		    ())
+
+RTIO_SOURCES(RTIO_SOURCE_IODEV)
+
+struct rtio_source {
+	const struct device *device;
+	enum sensor_channel channel;
+	struct rtio_iodev *iodev;
+};
+
+static const struct rtio_source sources[] = { RTIO_SOURCES(RTIO_SOURCE_ITEM) };
+
+// completions do not refer to their I/O devices, so each read carries one
+struct rtio_read {
+	const struct rtio_source *source;
+	void *userdata;
+	// batch in which the read was submitted, see sensor_rtio_submit()
+	uint32_t batch;
+	// set until the completion is consumed, also if it was given up on
+	bool in_flight;
+};
+
+static struct rtio_read reads[RTIO_QUEUE_SIZE];
+// batch of the reads queued since the last sensor_rtio_submit()
+static uint32_t queued_batch;
+// batch whose completions sensor_rtio_complete() waits for
+static uint32_t submitted_batch;
+
+// the read completed last, see sensor_rtio_get()
+static const struct rtio_source *completed_source;
+static uint8_t *completed_buffer;
+static uint32_t completed_buffer_len;
+
+RTIO_DEFINE_WITH_MEMPOOL(sensor_rtio_ctx, RTIO_QUEUE_SIZE, RTIO_QUEUE_SIZE,
+			 RTIO_QUEUE_SIZE * RTIO_BLOCKS_PER_READ, RTIO_BLOCK_SIZE, sizeof(void *));
+
+// the first source of each device reads the channels of all its sources
+static const struct rtio_source *find_source(const struct device *device)
+{
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(sources); i++) {
+		if (sources[i].device == device) {
+			return &sources[i];
+		}
+	}
+	return NULL;
+}
+
+static bool source_has_channel(const struct rtio_source *source, enum sensor_channel channel)
+{
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(sources); i++) {
+		if (sources[i].device == source->device && sources[i].channel == channel) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void configure_sources(void)
+{
+	static bool configured;
+
+	if (configured) {
+		return;
+	}
+
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(sources); i++) {
+		RTIO_CHANNEL_TYPE channels[RTIO_CHANNELS_MAX];
+		size_t channels_count = 0;
+
+		if (find_source(sources[i].device) != &sources[i]) {
+			continue;
+		}
+		for (size_t j = i; j < AVS_ARRAY_SIZE(sources); j++) {
+			if (sources[j].device == sources[i].device &&
+			    channels_count < AVS_ARRAY_SIZE(channels)) {
+				channels[channels_count++] =
+					(RTIO_CHANNEL_TYPE)RTIO_CHANNEL(sources[j].channel);
+			}
+		}
+
+		int err = sensor_reconfigure_read_iodev(sources[i].iodev, sources[i].device,
+							channels, channels_count);
+
+		if (err) {
+			LOG_WRN("Could not configure reads of %s: %d", sources[i].device->name, err);
+		}
+	}
+	configured = true;
+}
+
+int sensor_rtio_queue(const struct device *device, const enum sensor_channel *channels,
+		      size_t channels_count, void *userdata)
+{
+	configure_sources();
+
+	const struct rtio_source *source = find_source(device);
+
+	if (!source) {
+		return -ENOENT;
+	}
+	for (size_t i = 0; i < channels_count; i++) {
+		if (!source_has_channel(source, channels[i])) {
+			return -ENOENT;
+		}
+	}
+
+	// a read given up on by sensor_rtio_complete() keeps its slot until it completes
+	struct rtio_read *read = NULL;
+
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(reads); i++) {
+		if (!reads[i].in_flight) {
+			read = &reads[i];
+			break;
+		}
+	}
+
+	struct rtio_sqe *sqe = read ? rtio_sqe_acquire(&sensor_rtio_ctx) : NULL;
+
+	if (!sqe) {
+		return -ENOMEM;
+	}
+
+	read->source = source;
+	read->userdata = userdata;
+	read->batch = queued_batch;
+	read->in_flight = true;
+	rtio_sqe_prep_read_with_pool(sqe, source->iodev, RTIO_PRIO_NORM, read);
+	return 0;
+}
+
+void sensor_rtio_submit(void)
+{
+	submitted_batch = queued_batch++;
+	rtio_submit(&sensor_rtio_ctx, 0);
+}
+
+static double q31_to_double(q31_t value, int8_t shift)
+{
+	return ldexp((double)value, shift - 31);
+}
+
+static int decode(const struct device *device, enum sensor_channel channel,
+		  const uint8_t *buffer, double *out_values)
+{
+	const struct sensor_decoder_api *decoder;
+	int err = sensor_get_decoder(device, &decoder);
+
+	if (err) {
+		return err;
+	}
+
+	struct sensor_decode_context ctx = SENSOR_DECODE_CONTEXT_INIT(decoder, buffer, channel, 0);
+
+	if (SENSOR_CHANNEL_3_AXIS(channel)) {
+		struct sensor_three_axis_data data;
+
+		if (sensor_decode(&ctx, &data, 1) != 1) {
+			return -EIO;
+		}
+		for (size_t i = 0; i < SENSOR_RTIO_VALUES; i++) {
+			out_values[i] = q31_to_double(data.readings[0].values[i], data.shift);
+		}
+	} else {
+		struct sensor_q31_data data;
+
+		if (sensor_decode(&ctx, &data, 1) != 1) {
+			return -EIO;
+		}
+		out_values[0] = q31_to_double(data.readings[0].value, data.shift);
+	}
+	return 0;
+}
+
+/**
+ * rtio_cqe_consume_block() cannot time out, so the completion queue is polled
+ * instead, which only happens while reads of the batch are still pending.
+ */
+static struct rtio_cqe *consume_until(int64_t deadline_ms)
+{
+	struct rtio_cqe *cqe;
+
+	while (!(cqe = rtio_cqe_consume(&sensor_rtio_ctx))) {
+		if (k_uptime_get() >= deadline_ms) {
+			return NULL;
+		}
+		k_sleep(K_MSEC(CQE_POLL_PERIOD_MS));
+	}
+	return cqe;
+}
+
+int sensor_rtio_complete(int64_t deadline_ms, void **out_userdata)
+{
+	sensor_rtio_release();
+
+	while (true) {
+		struct rtio_cqe *cqe = consume_until(deadline_ms);
+
+		if (!cqe) {
+			return -ETIMEDOUT;
+		}
+
+		struct rtio_read *read = cqe->userdata;
+		int result = cqe->result;
+		uint8_t *buffer = NULL;
+		uint32_t buffer_len = 0;
+
+		if (!result) {
+			result = rtio_cqe_get_mempool_buffer(&sensor_rtio_ctx, cqe, &buffer,
+							     &buffer_len);
+		}
+		rtio_cqe_release(&sensor_rtio_ctx, cqe);
+		read->in_flight = false;
+
+		if (read->batch != submitted_batch) {
+			// completed after its batch was given up on, so nobody waits for it
+			if (buffer) {
+				rtio_release_buffer(&sensor_rtio_ctx, buffer, buffer_len);
+			}
+			LOG_DBG("Dropped late read of %s", read->source->device->name);
+			continue;
+		}
+
+		*out_userdata = read->userdata;
+		if (result) {
+			if (buffer) {
+				rtio_release_buffer(&sensor_rtio_ctx, buffer, buffer_len);
+			}
+			return result;
+		}
+
+		completed_source = read->source;
+		completed_buffer = buffer;
+		completed_buffer_len = buffer_len;
+		return 0;
+	}
+}
+
+int sensor_rtio_get(enum sensor_channel channel, double *out_values)
+{
+	if (!completed_buffer) {
+		return -ENODATA;
+	}
+	return decode(completed_source->device, channel, completed_buffer, out_values);
+}
+
+void sensor_rtio_release(void)
+{
+	if (completed_buffer) {
+		rtio_release_buffer(&sensor_rtio_ctx, completed_buffer, completed_buffer_len);
+		completed_buffer = NULL;
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#define SENSOR_RTIO_VALUES 3
+
+/**
+ * Queues a single read of all channels of @p device used by the sensors of
+ * sensors_config.c on the RTIO context shared by all sensors, so that a device
+ * shared by several sensors is accessed only once. The read is not started
+ * until sensor_rtio_submit() is called.
+ *
+ * @param channels Channels that the caller needs; the read fails if any of
+ *                 them cannot be read with RTIO.
+ *
+ * @returns 0 on success, -ENOENT if there is no RTIO device for some of the
+ *          given channels, or -ENOMEM if the submission queue is full or all
+ *          reads are still in flight.
+ */
+int sensor_rtio_queue(const struct device *device, const enum sensor_channel *channels,
+		      size_t channels_count, void *userdata);
+
+/**
+ * Starts all queued reads at once, as a new batch. The sensor drivers that
+ * implement the asynchronous API perform them in the background; the others
+ * are read synchronously, one after another, before this function returns.
+ */
+void sensor_rtio_submit(void);
+
+/**
+ * Waits for the next read of the batch submitted last to complete. On success,
+ * its channels can be decoded with sensor_rtio_get() until
+ * sensor_rtio_release() or the next call to this function. Reads of earlier
+ * batches that complete meanwhile are dropped.
+ *
+ * @param deadline_ms  Uptime after which the wait is given up on.
+ * @param out_userdata Set to the userdata passed to sensor_rtio_queue(), also
+ *                     if the read failed, but not on timeout.
+ *
+ * @returns 0 on success, -ETIMEDOUT if no read completed before
+ *          @p deadline_ms, or a negative error of the read.
+ */
+int sensor_rtio_complete(int64_t deadline_ms, void **out_userdata);
+
+/**
+ * Decodes @p channel of the read completed last into @p out_values, in the
+ * units of sensor_channel_get().
+ *
+ * @param out_values Array of SENSOR_RTIO_VALUES values, of which only the
+ *                   first one is set for single-value channels.
+ *
+ * @returns 0 on success, or a negative error of decoding.
+ */
+int sensor_rtio_get(enum sensor_channel channel, double *out_values);
+
+/**
+ * Releases the buffer of the read completed last.
+ */
+void sensor_rtio_release(void);
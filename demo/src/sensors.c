@@ -0,0 +1,1204 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/version.h>
+
+#include <anjay/ipso_objects.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "benchmark.h"
+#include "sample_buffer.h"
+#include "sensor_diagnostics.h"
+#include "sensor_health.h"
+#include "sensor_mailbox.h"
+#include "sensor_rtio.h"
+#include "sensor_cache.h"
+#include "sensors.h"
+#include "update_scheduler.h"
+
+LOG_MODULE_REGISTER(sensors);
+
+/**
+ * Sensor Value: R, Single, Mandatory
+ * type: float, range: N/A, unit: N/A
+ * Last or Current Measured Value from the Sensor.
+ */
+#define RID_SENSOR_VALUE 5700
+
+/**
+ * X Value: R, Single, Mandatory
+ * type: float, range: N/A, unit: N/A
+ * The measured value along the X axis.
+ */
+#define RID_X_VALUE 5702
+
+/**
+ * Y Value: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * The measured value along the Y axis.
+ */
+#define RID_Y_VALUE 5703
+
+/**
+ * Z Value: R, Single, Optional
+ * type: float, range: N/A, unit: N/A
+ * The measured value along the Z axis.
+ */
+#define RID_Z_VALUE 5704
+
+#define SAMPLING_INTERVAL_MIN_MS 100
+// how often the update loop checks whether pending devices became ready
+#define DEVICE_INIT_POLL_INTERVAL_MS 100
+
+enum device_init_state {
+	DEVICE_INIT_PENDING,
+	DEVICE_INIT_READY,
+	DEVICE_INIT_FAILED
+};
+
+// sensors sharing a single device, e.g. temperature and humidity of HTS221
+#define SENSORS_PER_DEVICE_MAX 4
+
+struct sensor_device_state {
+	struct k_work init_work;
+	const struct device *device;
+	atomic_t init_state;
+	// uptime of the last fetch by sensors_sample()
+	int64_t sample_timestamp_ms;
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+	// sensors whose samples are published to their mailboxes
+	struct sensor_context *consumers[SENSORS_PER_DEVICE_MAX];
+	size_t consumers_count;
+#endif // CONFIG_APP_SENSOR_MAILBOX
+#ifdef CONFIG_APP_SENSOR_TRIGGER
+	// set if samples are pushed by the data-ready trigger instead of fetched
+	atomic_t triggered;
+#endif // CONFIG_APP_SENSOR_TRIGGER
+#ifdef CONFIG_APP_SENSOR_HUB
+	// the shortest sampling interval requested by the consumers, 0 if none
+	atomic_t hub_period_ms;
+	// owned by the hub thread
+	int64_t hub_last_fetch_ms;
+	bool hub_fetched;
+#endif // CONFIG_APP_SENSOR_HUB
+};
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+static struct sensor_mailbox mailboxes[SENSORS_MAX_INSTALLED];
+static size_t mailboxes_count;
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+// kept across Anjay restarts, as devices are initialized only once
+static struct sensor_device_state device_states[SENSORS_MAX_INSTALLED];
+static size_t device_states_count;
+
+// runs the device initialization and the circuit breaker probes
+static K_THREAD_STACK_DEFINE(init_work_q_stack, CONFIG_APP_SENSORS_INIT_STACK_SIZE);
+static struct k_work_q init_work_q;
+
+static struct sensor_context *installed_sensors[SENSORS_MAX_INSTALLED];
+static size_t installed_sensors_count;
+// set while the value is read to be reported to Anjay, rather than for a Read
+static bool updating;
+// held changes are being reported, see sensors_flush_held()
+static bool releasing;
+
+static double scaled(const struct sensor_context *sensor, const struct sensor_value *value)
+{
+	double result = sensor_value_to_double(value);
+
+	return sensor->scale_factor ? result * sensor->scale_factor : result;
+}
+
+static int fetch_sample(const struct sensor_context *sensor)
+{
+	// all channels of a device are fetched at once and shared between sensors
+	int err = sensor_cache_fetch(sensor->device);
+
+	// -EAGAIN means that the circuit breaker is open, which is already logged
+	if (err && err != -EAGAIN) {
+		LOG_WRN("Failed to fetch %s sample: %d", sensor->name, err);
+	}
+	return err;
+}
+
+static bool exceeds_deadband(const struct sensor_context *sensor, double reported, double value)
+{
+	if (isnan(reported)) {
+		return true;
+	}
+
+	double delta = fabs(value - reported);
+
+	return delta > sensor->deadband_abs && delta > sensor->deadband_rel * fabs(reported);
+}
+
+#ifdef CONFIG_APP_SAMPLE_BUFFER
+static void buffer_samples(const struct sensor_context *sensor, const double *values,
+			   size_t values_count)
+{
+	if (!sensor->three_axis) {
+		sample_buffer_add(sensor->oid, sensor->iid, RID_SENSOR_VALUE, values[0]);
+		return;
+	}
+
+	for (size_t i = 0; i < values_count; i++) {
+		if ((i == 1 && !sensor->use_y_value) || (i == 2 && !sensor->use_z_value)) {
+			continue;
+		}
+		sample_buffer_add(sensor->oid, sensor->iid, RID_X_VALUE + i, values[i]);
+	}
+}
+#endif // CONFIG_APP_SAMPLE_BUFFER
+
+static bool outside_urgent_range(const struct sensor_context *sensor, double value)
+{
+	return sensor->urgent_low < sensor->urgent_high &&
+	       (value < sensor->urgent_low || value > sensor->urgent_high);
+}
+
+static bool is_urgent(const struct sensor_context *sensor, const double *values,
+		      size_t values_count)
+{
+	for (size_t i = 0; i < values_count; i++) {
+		if (outside_urgent_range(sensor, values[i]) ||
+		    outside_urgent_range(sensor, sensor->reported_values[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Replaces freshly sampled values with the last reported ones, unless the
+ * change of any of them exceeds the deadband. This way Anjay does not see a
+ * change and does not send a notification for it. While notifications are
+ * held, the same applies to non-urgent changes exceeding the deadband, which
+ * are reported on the next flush instead. The deadband only filters what is
+ * reported by sensors_update(), Reads of the server get the live sample.
+ */
+static void apply_deadband(struct sensor_context *sensor, double *values, size_t values_count)
+{
+	bool changed = false;
+	bool differs = false;
+
+	// neither the deadband nor the hold may make a Read return stale values,
+	// nor may a Read change what the next update reports
+	if (!updating) {
+		return;
+	}
+
+	for (size_t i = 0; i < values_count; i++) {
+		changed = changed || exceeds_deadband(sensor, sensor->reported_values[i], values[i]);
+		differs = differs || values[i] != sensor->reported_values[i];
+	}
+
+	if (changed) {
+#ifdef CONFIG_APP_SAMPLE_BUFFER
+		buffer_samples(sensor, values, values_count);
+#endif // CONFIG_APP_SAMPLE_BUFFER
+		// the first sample is never held, it is not notified anyway
+		bool holding = update_scheduler_holding() && !releasing &&
+			       !isnan(sensor->reported_values[0]);
+
+		if (holding && !is_urgent(sensor, values, values_count)) {
+			sensor->held = true;
+			memcpy(values, sensor->reported_values, values_count * sizeof(*values));
+			return;
+		}
+		if (holding) {
+			// the radio is woken up anyway, so send the held changes too
+			update_scheduler_flush_soon();
+		}
+		memcpy(sensor->reported_values, values, values_count * sizeof(*values));
+		sensor->held = false;
+		return;
+	}
+
+	if (differs) {
+		sensor->suppressed_notifications++;
+	}
+	memcpy(values, sensor->reported_values, values_count * sizeof(*values));
+}
+
+#ifdef CONFIG_APP_SENSOR_STATS
+static void window_stats_reset(struct sensor_window_stats *stats)
+{
+	*stats = (struct sensor_window_stats){ .min = NAN, .max = NAN, .mean = NAN };
+}
+
+static void window_stats_add(struct sensor_context *sensor, const double *values)
+{
+	struct sensor_window_stats *stats = &sensor->window;
+	double value = values[0];
+
+	if (sensor->three_axis) {
+		double y = sensor->use_y_value ? values[1] : 0.0;
+		double z = sensor->use_z_value ? values[2] : 0.0;
+
+		value = sqrt(value * value + y * y + z * z);
+	}
+
+	if (!stats->count++) {
+		stats->min = value;
+		stats->max = value;
+		stats->mean = value;
+		stats->m2 = 0.0;
+		return;
+	}
+
+	double delta = value - stats->mean;
+
+	stats->min = MIN(stats->min, value);
+	stats->max = MAX(stats->max, value);
+	stats->mean += delta / stats->count;
+	stats->m2 += delta * (value - stats->mean);
+}
+
+static void window_stats_publish(anjay_t *anjay, struct sensor_context *sensor,
+				 avs_time_monotonic_t now)
+{
+	sensor->last_window = sensor->window;
+	window_stats_reset(&sensor->window);
+	sensor->window_end = avs_time_monotonic_add(
+		now, avs_time_duration_from_scalar(CONFIG_APP_SENSOR_STATS_WINDOW_S, AVS_TIME_S));
+	sensor_diagnostics_notify_stats(anjay, sensor);
+}
+
+double sensor_window_stats_stddev(const struct sensor_window_stats *stats)
+{
+	return stats->count > 1 ? sqrt(stats->m2 / (stats->count - 1)) : 0.0;
+}
+#endif // CONFIG_APP_SENSOR_STATS
+
+static bool device_ready(const struct sensor_context *sensor)
+{
+	return atomic_get(&sensor->device_state->init_state) == DEVICE_INIT_READY;
+}
+
+static struct sensor_device_state *find_device_state(const struct device *device)
+{
+	for (size_t i = 0; i < device_states_count; i++) {
+		if (device_states[i].device == device) {
+			return &device_states[i];
+		}
+	}
+	return NULL;
+}
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+// called outside of the Anjay thread, by the only producer of the mailboxes
+static int publish_device_sample(struct sensor_device_state *state)
+{
+	int err = sensor_health_fetch(state->device);
+
+	if (err) {
+		return err;
+	}
+
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		struct sensor_context *sensor = state->consumers[i];
+		struct sensor_value raw[3] = { 0 };
+
+		if (!sensor_channel_get(state->device, sensor->channel, raw)) {
+			double values[SENSOR_MAILBOX_VALUES] = { scaled(sensor, &raw[0]),
+								 scaled(sensor, &raw[1]),
+								 scaled(sensor, &raw[2]) };
+
+			sensor_mailbox_publish(sensor->mailbox, values, k_uptime_get());
+		}
+	}
+	return 0;
+}
+
+static void add_consumer(struct sensor_device_state *state, struct sensor_context *sensor)
+{
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		if (state->consumers[i] == sensor) {
+			return;
+		}
+	}
+
+	if (!sensor->mailbox) {
+		if (mailboxes_count >= AVS_ARRAY_SIZE(mailboxes)) {
+			return;
+		}
+		sensor->mailbox = &mailboxes[mailboxes_count++];
+		sensor_mailbox_init(sensor->mailbox);
+	}
+
+	if (state->consumers_count < AVS_ARRAY_SIZE(state->consumers)) {
+		state->consumers[state->consumers_count++] = sensor;
+	}
+}
+
+static bool uses_mailbox(const struct sensor_context *sensor)
+{
+	if (!sensor->mailbox) {
+		return false;
+	}
+#ifdef CONFIG_APP_SENSOR_HUB
+	// the hub thread owns all the I/O of the devices it serves
+	return true;
+#else  // CONFIG_APP_SENSOR_HUB
+	return atomic_get(&sensor->device_state->triggered);
+#endif // CONFIG_APP_SENSOR_HUB
+}
+
+static void drain_queued_samples(struct sensor_context *sensor)
+{
+	double queued[SENSOR_MAILBOX_VALUES];
+
+	while (sensor_mailbox_pop(sensor->mailbox, queued)) {
+#ifdef CONFIG_APP_SENSOR_STATS
+		window_stats_add(sensor, queued);
+#endif // CONFIG_APP_SENSOR_STATS
+	}
+}
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+#ifdef CONFIG_APP_SENSOR_TRIGGER
+static void data_ready_handler(const struct device *device, const struct sensor_trigger *trigger)
+{
+	(void)trigger;
+
+	struct sensor_device_state *state = find_device_state(device);
+
+	if (state) {
+		publish_device_sample(state);
+	}
+}
+
+static bool trigger_wanted(const struct sensor_device_state *state)
+{
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		if (state->consumers[i]->use_trigger) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void setup_trigger(struct sensor_device_state *state)
+{
+	static const struct sensor_trigger data_ready = { .type = SENSOR_TRIG_DATA_READY,
+							  .chan = SENSOR_CHAN_ALL };
+
+	if (!trigger_wanted(state)) {
+		return;
+	}
+
+	int err = sensor_trigger_set(state->device, &data_ready, data_ready_handler);
+
+	if (err) {
+		// e.g. trigger support is not enabled in the driver
+		LOG_WRN("Data-ready trigger unavailable for %s (%d), polling instead",
+			state->device->name, err);
+		return;
+	}
+	atomic_set(&state->triggered, true);
+}
+#endif // CONFIG_APP_SENSOR_TRIGGER
+
+#ifdef CONFIG_APP_SENSOR_HUB
+static K_THREAD_STACK_DEFINE(hub_stack, CONFIG_APP_SENSOR_HUB_STACK_SIZE);
+static struct k_thread hub_thread;
+static K_SEM_DEFINE(hub_wakeup, 0, 1);
+
+static bool served_by_hub(struct sensor_device_state *state)
+{
+#ifdef CONFIG_APP_SENSOR_TRIGGER
+	if (atomic_get(&state->triggered)) {
+		return false;
+	}
+#endif // CONFIG_APP_SENSOR_TRIGGER
+	return atomic_get(&state->init_state) == DEVICE_INIT_READY &&
+	       atomic_get(&state->hub_period_ms) > 0;
+}
+
+static void hub_fetch(struct sensor_device_state *state)
+{
+	int err = publish_device_sample(state);
+
+	if (err && err != -EAGAIN) {
+		LOG_WRN("Failed to fetch %s sample: %d", state->device->name, err);
+	}
+}
+
+#ifdef CONFIG_APP_SENSOR_RTIO
+BUILD_ASSERT(SENSOR_RTIO_VALUES == SENSOR_MAILBOX_VALUES);
+
+// a single read of all channels, so that devices shared by sensors are read once
+static bool hub_queue_read(struct sensor_device_state *state)
+{
+	enum sensor_channel channels[SENSORS_PER_DEVICE_MAX];
+
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		channels[i] = state->consumers[i]->channel;
+	}
+	return !sensor_rtio_queue(state->device, channels, state->consumers_count, state);
+}
+
+static void hub_publish_read(struct sensor_device_state *state)
+{
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		struct sensor_context *sensor = state->consumers[i];
+		double values[SENSOR_RTIO_VALUES] = { 0 };
+		int err = sensor_rtio_get(sensor->channel, values);
+
+		if (err) {
+			LOG_WRN("Failed to decode %s sample: %d", sensor->name, err);
+			continue;
+		}
+
+		for (size_t j = 0; j < SENSOR_RTIO_VALUES; j++) {
+			values[j] = sensor->scale_factor ? values[j] * sensor->scale_factor
+							 : values[j];
+		}
+		sensor_mailbox_publish(sensor->mailbox, values, k_uptime_get());
+	}
+}
+
+/**
+ * Reads of all the due devices that have RTIO devices are queued and started
+ * at once, one per device, then the remaining ones are fetched synchronously,
+ * while the former may still be in progress.
+ */
+static void hub_fetch_batch(struct sensor_device_state **due, size_t due_count)
+{
+	struct sensor_device_state *serial[SENSORS_MAX_INSTALLED];
+	struct sensor_device_state *queued[SENSORS_MAX_INSTALLED];
+	size_t serial_count = 0;
+	size_t queued_count = 0;
+
+	for (size_t i = 0; i < due_count; i++) {
+		if (sensor_health_paused(due[i]->device)) {
+			continue;
+		}
+		if (hub_queue_read(due[i])) {
+			queued[queued_count++] = due[i];
+		} else {
+			serial[serial_count++] = due[i];
+		}
+	}
+
+	uint32_t submit_cycles = k_cycle_get_32();
+
+	sensor_rtio_submit();
+	for (size_t i = 0; i < serial_count; i++) {
+		hub_fetch(serial[i]);
+	}
+
+	int64_t deadline_ms = k_uptime_get() + CONFIG_APP_SENSOR_RTIO_TIMEOUT_MS;
+
+	for (size_t completed = 0; completed < queued_count; completed++) {
+		void *userdata = NULL;
+		int err = sensor_rtio_complete(deadline_ms, &userdata);
+
+		// not set only if no read completed in time
+		if (!userdata) {
+			break;
+		}
+
+		struct sensor_device_state *state = userdata;
+
+		for (size_t i = 0; i < queued_count; i++) {
+			if (queued[i] == state) {
+				queued[i] = NULL;
+			}
+		}
+		// the latency includes waiting for the preceding reads on the same bus
+		sensor_health_record(state->device, err,
+				     k_cyc_to_us_floor32(k_cycle_get_32() - submit_cycles));
+		if (err) {
+			LOG_WRN("Failed to read %s sample: %d", state->device->name, err);
+			continue;
+		}
+		hub_publish_read(state);
+	}
+	sensor_rtio_release();
+
+	// reads that are still pending are given up on until the next batch
+	for (size_t i = 0; i < queued_count; i++) {
+		if (queued[i]) {
+			sensor_health_record(queued[i]->device, -ETIMEDOUT,
+					     k_cyc_to_us_floor32(k_cycle_get_32() - submit_cycles));
+			LOG_WRN("Timed out reading %s sample", queued[i]->device->name);
+		}
+	}
+}
+#else  // CONFIG_APP_SENSOR_RTIO
+static void hub_fetch_batch(struct sensor_device_state **due, size_t due_count)
+{
+	for (size_t i = 0; i < due_count; i++) {
+		hub_fetch(due[i]);
+	}
+}
+#endif // CONFIG_APP_SENSOR_RTIO
+
+static void hub_thread_main(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		int64_t now = k_uptime_get();
+		int64_t next_fetch_ms = INT64_MAX;
+		struct sensor_device_state *due[SENSORS_MAX_INSTALLED];
+		size_t due_count = 0;
+
+		// device states are only added before the thread is started
+		for (size_t i = 0; i < device_states_count; i++) {
+			struct sensor_device_state *state = &device_states[i];
+
+			if (!served_by_hub(state)) {
+				continue;
+			}
+
+			int64_t period_ms = atomic_get(&state->hub_period_ms);
+			int64_t due_ms = state->hub_fetched ? state->hub_last_fetch_ms + period_ms : now;
+
+			if (due_ms <= now) {
+				due[due_count++] = state;
+				state->hub_last_fetch_ms = now;
+				state->hub_fetched = true;
+				due_ms = now + period_ms;
+			}
+			next_fetch_ms = MIN(next_fetch_ms, due_ms);
+		}
+
+		if (due_count) {
+			benchmark_hub_batch_begin();
+			hub_fetch_batch(due, due_count);
+			benchmark_hub_batch_end();
+		}
+
+		k_timeout_t timeout = K_FOREVER;
+
+		if (next_fetch_ms != INT64_MAX) {
+			timeout = K_MSEC(MAX(next_fetch_ms - k_uptime_get(), 0));
+		}
+		// woken up early when a sampling interval changes
+		k_sem_take(&hub_wakeup, timeout);
+	}
+}
+
+/**
+ * Called by the Anjay thread. The hub fetches the device as often as the most
+ * demanding of the sensors that share it requires, either for their
+ * observations or for sensors_request_interval().
+ */
+static void hub_update_period(struct sensor_device_state *state)
+{
+	int64_t period_ms = INT64_MAX;
+
+	for (size_t i = 0; i < state->consumers_count; i++) {
+		const struct sensor_context *consumer = state->consumers[i];
+
+		if (!consumer->installed) {
+			continue;
+		}
+		if (consumer->hub_interval_ms > 0) {
+			period_ms = MIN(period_ms, consumer->hub_interval_ms);
+		}
+		if (consumer->hub_requested_ms > 0) {
+			period_ms = MIN(period_ms, consumer->hub_requested_ms);
+		}
+	}
+
+	if (period_ms == INT64_MAX) {
+		period_ms = 0;
+	}
+	if (period_ms != atomic_get(&state->hub_period_ms)) {
+		atomic_set(&state->hub_period_ms, (atomic_val_t)period_ms);
+		k_sem_give(&hub_wakeup);
+	}
+}
+
+static void hub_request_interval(struct sensor_context *sensor, int64_t interval_ms)
+{
+	sensor->hub_interval_ms = interval_ms;
+	hub_update_period(sensor->device_state);
+}
+#endif // CONFIG_APP_SENSOR_HUB
+
+static int read_latest(struct sensor_context *sensor, double *values, size_t values_count)
+{
+	if (!device_ready(sensor)) {
+		return -1;
+	}
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+	if (uses_mailbox(sensor)) {
+		double latest[SENSOR_MAILBOX_VALUES];
+
+		if (sensor_mailbox_latest(sensor->mailbox, latest, NULL)) {
+			return -1;
+		}
+		memcpy(values, latest, values_count * sizeof(*values));
+		return 0;
+	}
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+	struct sensor_value raw[3] = { 0 };
+
+	if (fetch_sample(sensor) || sensor_channel_get(sensor->device, sensor->channel, raw)) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < values_count; i++) {
+		values[i] = scaled(sensor, &raw[i]);
+	}
+	return 0;
+}
+
+/**
+ * Reads the current value(s) of the sensor. While sensors_update() samples it,
+ * the samples taken since the previous update are also aggregated into the
+ * window statistics, each of them once - Reads of the server and samples
+ * served again from the cache would bias them.
+ */
+static int read_sample(struct sensor_context *sensor, double *values, size_t values_count)
+{
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+	if (device_ready(sensor) && uses_mailbox(sensor)) {
+		if (updating) {
+			// samples published since the previous update
+			drain_queued_samples(sensor);
+		}
+		return read_latest(sensor, values, values_count);
+	}
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+	int err = read_latest(sensor, values, values_count);
+
+#ifdef CONFIG_APP_SENSOR_STATS
+	if (!err && updating) {
+		int64_t sample_ms = sensor_cache_sample_timestamp(sensor->device);
+
+		if (sample_ms < 0 || sample_ms != sensor->window_sample_ms) {
+			sensor->window_sample_ms = sample_ms;
+			window_stats_add(sensor, values);
+		}
+	}
+#endif // CONFIG_APP_SENSOR_STATS
+	return err;
+}
+
+static int read_value(anjay_iid_t iid, void *user_context, double *out_value)
+{
+	(void)iid;
+
+	struct sensor_context *sensor = (struct sensor_context *)user_context;
+
+	if (read_sample(sensor, out_value, 1)) {
+		return -1;
+	}
+
+	apply_deadband(sensor, out_value, 1);
+	return 0;
+}
+
+static int read_three_axis_values(anjay_iid_t iid, void *user_context, double *out_x,
+				  double *out_y, double *out_z)
+{
+	(void)iid;
+
+	struct sensor_context *sensor = (struct sensor_context *)user_context;
+	double result[3];
+
+	if (read_sample(sensor, result, 3)) {
+		return -1;
+	}
+
+	apply_deadband(sensor, result, 3);
+	*out_x = result[0];
+	*out_y = result[1];
+	*out_z = result[2];
+	return 0;
+}
+
+static void device_init_work_handler(struct k_work *work)
+{
+	struct sensor_device_state *state = CONTAINER_OF(work, struct sensor_device_state, init_work);
+	int64_t start_ms = k_uptime_get();
+	int err = 0;
+
+	// zephyr,deferred-init is not supported before Zephyr 4.0
+#if KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(4, 0, 0)
+	// -ENOENT means that the device is not marked with zephyr,deferred-init
+	err = device_init(state->device);
+	if (err == -ENOENT) {
+		err = 0;
+	}
+#endif // KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(4, 0, 0)
+
+	if (err || !device_is_ready(state->device)) {
+		LOG_WRN("%s device is not ready", state->device->name);
+		atomic_set(&state->init_state, DEVICE_INIT_FAILED);
+		return;
+	}
+
+	// the first sample of some drivers takes much longer than the following ones
+	err = sensor_sample_fetch(state->device);
+	if (err) {
+		LOG_WRN("Failed to fetch the first %s sample: %d", state->device->name, err);
+	}
+
+#ifdef CONFIG_APP_SENSOR_TRIGGER
+	setup_trigger(state);
+#endif // CONFIG_APP_SENSOR_TRIGGER
+
+	LOG_INF("%s ready at %lld ms since boot (initialized in %lld ms)", state->device->name,
+		k_uptime_get(), k_uptime_get() - start_ms);
+	atomic_set(&state->init_state, DEVICE_INIT_READY);
+}
+
+static struct sensor_device_state *get_device_state(const struct device *device)
+{
+	struct sensor_device_state *state = find_device_state(device);
+
+	if (state) {
+		return state;
+	}
+
+	if (device_states_count >= AVS_ARRAY_SIZE(device_states)) {
+		return NULL;
+	}
+
+	state = &device_states[device_states_count];
+	state->device = device;
+	atomic_set(&state->init_state, DEVICE_INIT_PENDING);
+	k_work_init(&state->init_work, device_init_work_handler);
+	// published last, as trigger handlers look the states up concurrently
+	device_states_count++;
+	return state;
+}
+
+static int install_sensor(anjay_t *anjay, struct sensor_context *sensor, anjay_oid_t oid,
+			  anjay_iid_t iid, bool three_axis)
+{
+	sensor->oid = oid;
+	sensor->iid = iid;
+	sensor->three_axis = three_axis;
+	sensor->installed = false;
+	sensor->next_sample = AVS_TIME_MONOTONIC_INVALID;
+	sensor->reported_values[0] = NAN;
+	sensor->reported_values[1] = NAN;
+	sensor->reported_values[2] = NAN;
+	sensor->suppressed_notifications = 0;
+	sensor->held = false;
+#ifdef CONFIG_APP_SENSOR_HUB
+	sensor->hub_requested_ms = 0;
+#endif // CONFIG_APP_SENSOR_HUB
+#ifdef CONFIG_APP_SENSOR_STATS
+	window_stats_reset(&sensor->window);
+	window_stats_reset(&sensor->last_window);
+	sensor->window_end = AVS_TIME_MONOTONIC_INVALID;
+	sensor->window_sample_ms = -1;
+#endif // CONFIG_APP_SENSOR_STATS
+
+	sensor->device_state = get_device_state(sensor->device);
+
+	if (installed_sensors_count >= AVS_ARRAY_SIZE(installed_sensors) ||
+	    !sensor->device_state) {
+		LOG_ERR("Could not install %s: too many sensors", sensor->name);
+		return -1;
+	}
+
+	if (atomic_get(&sensor->device_state->init_state) == DEVICE_INIT_FAILED) {
+		LOG_WRN("%s device is not ready", sensor->name);
+		return -1;
+	}
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+	add_consumer(sensor->device_state, sensor);
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+	int result;
+
+	if (three_axis) {
+		result = anjay_ipso_3d_sensor_instance_add(
+			anjay, oid, iid,
+			(anjay_ipso_3d_sensor_impl_t){ .unit = sensor->unit,
+						       .use_y_value = sensor->use_y_value,
+						       .use_z_value = sensor->use_z_value,
+						       .user_context = sensor,
+						       .min_range_value = sensor->min_range_value,
+						       .max_range_value = sensor->max_range_value,
+						       .get_values = read_three_axis_values });
+	} else {
+		result = anjay_ipso_basic_sensor_instance_add(
+			anjay, oid, iid,
+			(anjay_ipso_basic_sensor_impl_t){ .unit = sensor->unit,
+							  .user_context = sensor,
+							  .min_range_value = sensor->min_range_value,
+							  .max_range_value = sensor->max_range_value,
+							  .get_value = read_value });
+	}
+
+	if (result) {
+		return result;
+	}
+
+	sensor->installed = true;
+	installed_sensors[installed_sensors_count++] = sensor;
+	return 0;
+}
+
+int sensors_basic_install(anjay_t *anjay, struct sensor_oid_set *oid_sets, size_t oid_sets_count)
+{
+	for (size_t i = 0; i < oid_sets_count; i++) {
+		struct sensor_oid_set *oid_set = &oid_sets[i];
+
+		if (oid_set->sensors_count == 0 ||
+		    anjay_ipso_basic_sensor_install(anjay, oid_set->oid, oid_set->sensors_count)) {
+			continue;
+		}
+
+		for (anjay_iid_t iid = 0; iid < oid_set->sensors_count; iid++) {
+			install_sensor(anjay, &oid_set->sensors[iid], oid_set->oid, iid, false);
+		}
+	}
+
+	return 0;
+}
+
+int sensors_three_axis_install(anjay_t *anjay, struct sensor_oid_set *oid_sets,
+			       size_t oid_sets_count)
+{
+	for (size_t i = 0; i < oid_sets_count; i++) {
+		struct sensor_oid_set *oid_set = &oid_sets[i];
+
+		if (oid_set->sensors_count == 0 ||
+		    anjay_ipso_3d_sensor_install(anjay, oid_set->oid, oid_set->sensors_count)) {
+			continue;
+		}
+
+		for (anjay_iid_t iid = 0; iid < oid_set->sensors_count; iid++) {
+			install_sensor(anjay, &oid_set->sensors[iid], oid_set->oid, iid, true);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Returns the sampling interval required by observations of a single value
+ * resource, or -1 if it is not observed. The Step attributes do not affect the
+ * sampling rate - they are evaluated by Anjay on every notify_changed call.
+ */
+static int64_t observed_interval_ms(anjay_t *anjay, anjay_oid_t oid, anjay_iid_t iid,
+				    anjay_rid_t rid)
+{
+	anjay_resource_observation_status_t status =
+		anjay_resource_observation_status(anjay, oid, iid, rid, ANJAY_ID_INVALID);
+
+	if (!status.is_observed) {
+		return -1;
+	}
+
+	int64_t interval_ms = CONFIG_APP_SENSORS_UPDATE_PERIOD_MS;
+
+	// the value must be evaluated at least once every epmax...
+	if (status.max_eval_period != ANJAY_ATTRIB_INTEGER_NONE) {
+		interval_ms = AVS_MIN(interval_ms, (int64_t)status.max_eval_period * 1000);
+	}
+	// ...but there is no point in sampling more often than it can be notified
+	if (status.min_period != ANJAY_ATTRIB_INTEGER_NONE) {
+		interval_ms = AVS_MAX(interval_ms, (int64_t)status.min_period * 1000);
+	}
+
+	return AVS_MAX(interval_ms, SAMPLING_INTERVAL_MIN_MS);
+}
+
+static int64_t shorter_interval(int64_t a_ms, int64_t b_ms)
+{
+	if (a_ms < 0) {
+		return b_ms;
+	}
+	return b_ms < 0 ? a_ms : AVS_MIN(a_ms, b_ms);
+}
+
+static int64_t sampling_interval_ms(anjay_t *anjay, const struct sensor_context *sensor)
+{
+	if (!sensor->three_axis) {
+		return observed_interval_ms(anjay, sensor->oid, sensor->iid, RID_SENSOR_VALUE);
+	}
+
+	int64_t result = observed_interval_ms(anjay, sensor->oid, sensor->iid, RID_X_VALUE);
+
+	if (sensor->use_y_value) {
+		result = shorter_interval(
+			result, observed_interval_ms(anjay, sensor->oid, sensor->iid, RID_Y_VALUE));
+	}
+	if (sensor->use_z_value) {
+		result = shorter_interval(
+			result, observed_interval_ms(anjay, sensor->oid, sensor->iid, RID_Z_VALUE));
+	}
+	return result;
+}
+
+static void remove_sensor(anjay_t *anjay, struct sensor_context *sensor)
+{
+	LOG_WRN("Removing %s, as its device is not ready", sensor->name);
+
+	if (sensor->three_axis) {
+		anjay_ipso_3d_sensor_instance_remove(anjay, sensor->oid, sensor->iid);
+	} else {
+		anjay_ipso_basic_sensor_instance_remove(anjay, sensor->oid, sensor->iid);
+	}
+	anjay_notify_instances_changed(anjay, sensor->oid);
+
+	sensor->installed = false;
+	sensor->next_sample = AVS_TIME_MONOTONIC_INVALID;
+}
+
+// samples the sensor through the IPSO object, which notifies Anjay of changes
+static void update_ipso_object(anjay_t *anjay, struct sensor_context *sensor)
+{
+	updating = true;
+	if (sensor->three_axis) {
+		anjay_ipso_3d_sensor_update(anjay, sensor->oid, sensor->iid);
+	} else {
+		anjay_ipso_basic_sensor_update(anjay, sensor->oid, sensor->iid);
+	}
+	updating = false;
+}
+
+static void update_sensor(anjay_t *anjay, struct sensor_context *sensor, avs_time_monotonic_t now)
+{
+	if (!sensor->installed || (avs_time_monotonic_valid(sensor->next_sample) &&
+				   avs_time_monotonic_before(now, sensor->next_sample))) {
+		return;
+	}
+
+	switch (atomic_get(&sensor->device_state->init_state)) {
+	case DEVICE_INIT_PENDING:
+		sensor->next_sample = avs_time_monotonic_add(
+			now, avs_time_duration_from_scalar(DEVICE_INIT_POLL_INTERVAL_MS, AVS_TIME_MS));
+		return;
+
+	case DEVICE_INIT_FAILED:
+		remove_sensor(anjay, sensor);
+		return;
+
+	default:
+		break;
+	}
+
+	int64_t interval_ms = sampling_interval_ms(anjay, sensor);
+	// samples of sensors that are not observed may still be uploaded using Send
+	// or aggregated into window statistics
+	bool sample = interval_ms >= 0 || IS_ENABLED(CONFIG_APP_SAMPLE_BUFFER) ||
+		      IS_ENABLED(CONFIG_APP_SENSOR_STATS);
+
+	if (interval_ms < 0) {
+		// not observed - check again whether it became observed
+		interval_ms = CONFIG_APP_SENSORS_UPDATE_PERIOD_MS;
+	}
+
+#ifdef CONFIG_APP_SENSOR_HUB
+	// unobserved sensors are sampled too, so that Reads get a recent value
+	hub_request_interval(sensor, interval_ms);
+#endif // CONFIG_APP_SENSOR_HUB
+
+	if (sample) {
+		update_ipso_object(anjay, sensor);
+	}
+
+	sensor->next_sample =
+		avs_time_monotonic_add(now, avs_time_duration_from_scalar(interval_ms, AVS_TIME_MS));
+
+#ifdef CONFIG_APP_SENSOR_STATS
+	if (!avs_time_monotonic_valid(sensor->window_end)) {
+		sensor->window_end = avs_time_monotonic_add(
+			now,
+			avs_time_duration_from_scalar(CONFIG_APP_SENSOR_STATS_WINDOW_S, AVS_TIME_S));
+	} else if (!avs_time_monotonic_before(now, sensor->window_end)) {
+		window_stats_publish(anjay, sensor, now);
+	}
+	if (avs_time_monotonic_before(sensor->window_end, sensor->next_sample)) {
+		sensor->next_sample = sensor->window_end;
+	}
+#endif // CONFIG_APP_SENSOR_STATS
+}
+
+avs_time_monotonic_t sensors_update(anjay_t *anjay)
+{
+	avs_time_monotonic_t now = avs_time_monotonic_now();
+	avs_time_monotonic_t earliest = AVS_TIME_MONOTONIC_INVALID;
+
+	sensor_cache_new_cycle();
+
+	for (size_t i = 0; i < installed_sensors_count; i++) {
+		struct sensor_context *sensor = installed_sensors[i];
+
+		update_sensor(anjay, sensor, now);
+		if (avs_time_monotonic_valid(sensor->next_sample) &&
+		    (!avs_time_monotonic_valid(earliest) ||
+		     avs_time_monotonic_before(sensor->next_sample, earliest))) {
+			earliest = sensor->next_sample;
+		}
+	}
+
+	return earliest;
+}
+
+void sensors_expedite(avs_time_monotonic_t horizon)
+{
+	avs_time_monotonic_t now = avs_time_monotonic_now();
+
+	for (size_t i = 0; i < installed_sensors_count; i++) {
+		struct sensor_context *sensor = installed_sensors[i];
+
+		if (sensor->installed && avs_time_monotonic_valid(sensor->next_sample) &&
+		    avs_time_monotonic_before(sensor->next_sample, horizon)) {
+			sensor->next_sample = now;
+		}
+	}
+}
+
+bool sensors_flush_held(anjay_t *anjay)
+{
+	bool flushed = false;
+
+	releasing = true;
+	for (size_t i = 0; i < installed_sensors_count; i++) {
+		struct sensor_context *sensor = installed_sensors[i];
+
+		if (sensor->installed && sensor->held) {
+			// a fresh sample is taken, so the latest value is reported
+			update_ipso_object(anjay, sensor);
+			sensor->held = false;
+			// changes of sensors that are not observed are not notified
+			flushed = flushed || sampling_interval_ms(anjay, sensor) >= 0;
+		}
+	}
+	releasing = false;
+
+	return flushed;
+}
+
+void sensors_init_start(void)
+{
+	static bool work_q_started;
+
+	if (!work_q_started) {
+		k_work_queue_start(&init_work_q, init_work_q_stack,
+				   K_THREAD_STACK_SIZEOF(init_work_q_stack),
+				   K_LOWEST_APPLICATION_THREAD_PRIO,
+				   &(const struct k_work_queue_config){ .name = "sensors_init" });
+		sensor_health_init(&init_work_q);
+#ifdef CONFIG_APP_SENSOR_HUB
+		k_thread_create(&hub_thread, hub_stack, K_THREAD_STACK_SIZEOF(hub_stack),
+				hub_thread_main, NULL, NULL, NULL,
+				CONFIG_APP_SENSOR_HUB_THREAD_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&hub_thread, "sensor_hub");
+#endif // CONFIG_APP_SENSOR_HUB
+		work_q_started = true;
+	}
+
+	for (size_t i = 0; i < device_states_count; i++) {
+		if (atomic_get(&device_states[i].init_state) == DEVICE_INIT_PENDING) {
+			k_work_submit_to_queue(&init_work_q, &device_states[i].init_work);
+		}
+	}
+}
+
+int sensors_read_latest(struct sensor_context *sensor, double *out_values)
+{
+	return read_latest(sensor, out_values, sensor->three_axis ? 3 : 1);
+}
+
+void sensors_request_interval(struct sensor_context *sensor, int64_t interval_ms)
+{
+#ifdef CONFIG_APP_SENSOR_HUB
+	sensor->hub_requested_ms = interval_ms;
+	// otherwise taken into account once the device is ready, by sensors_update()
+	if (sensor->installed && device_ready(sensor)) {
+		hub_update_period(sensor->device_state);
+	}
+#else  // CONFIG_APP_SENSOR_HUB
+	// the samples are fetched by sensors_sample() itself
+	(void)sensor;
+	(void)interval_ms;
+#endif // CONFIG_APP_SENSOR_HUB
+}
+
+int sensors_sample(struct sensor_context *sensor, bool fetch, double *out_values,
+		   int64_t *out_timestamp_ms)
+{
+	size_t values_count = sensor->three_axis ? 3 : 1;
+
+	if (!device_ready(sensor)) {
+		return -1;
+	}
+
+#ifdef CONFIG_APP_SENSOR_MAILBOX
+	if (uses_mailbox(sensor)) {
+		double latest[SENSOR_MAILBOX_VALUES];
+
+		if (sensor_mailbox_latest(sensor->mailbox, latest, out_timestamp_ms)) {
+			return -1;
+		}
+		memcpy(out_values, latest, values_count * sizeof(*out_values));
+		return 0;
+	}
+#endif // CONFIG_APP_SENSOR_MAILBOX
+
+	struct sensor_device_state *state = sensor->device_state;
+
+	if (fetch) {
+		// the cache is bypassed, as it would serve the same sample repeatedly
+		if (sensor_health_fetch(sensor->device)) {
+			return -1;
+		}
+		state->sample_timestamp_ms = k_uptime_get();
+	}
+
+	struct sensor_value raw[3] = { 0 };
+
+	if (sensor_channel_get(sensor->device, sensor->channel, raw)) {
+		return -1;
+	}
+	for (size_t i = 0; i < values_count; i++) {
+		out_values[i] = scaled(sensor, &raw[i]);
+	}
+	*out_timestamp_ms = state->sample_timestamp_ms;
+	return 0;
+}
+
+size_t sensors_installed_count(void)
+{
+	return installed_sensors_count;
+}
+
+void sensors_release(void)
+{
+	installed_sensors_count = 0;
+}
+
+struct sensor_context *sensors_installed_get(size_t index)
+{
+	return index < installed_sensors_count ? installed_sensors[index] : NULL;
+}
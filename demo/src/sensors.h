@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_time.h>
+
+#define SENSORS_MAX_INSTALLED 16
+
+struct sensor_device_state;
+struct sensor_mailbox;
+
+/**
+ * Running statistics of the samples taken within a window, computed with the
+ * Welford's algorithm. For three-axis sensors, the magnitude of the vector of
+ * the used axes is aggregated.
+ */
+struct sensor_window_stats {
+	uint32_t count;
+	double min;
+	double max;
+	double mean;
+	// sum of squared differences from the mean
+	double m2;
+};
+
+struct sensor_context {
+	const char *name;
+	const char *unit;
+	const struct device *device;
+	enum sensor_channel channel;
+	double scale_factor;
+	bool use_y_value;
+	bool use_z_value;
+	double min_range_value;
+	double max_range_value;
+	/**
+	 * A change of the value is reported to Anjay only if it exceeds both
+	 * the absolute deadband and the relative one, i.e. the fraction of the
+	 * last reported value. Zero (the default) disables the given deadband.
+	 */
+	double deadband_abs;
+	double deadband_rel;
+	/**
+	 * If set and CONFIG_APP_SENSOR_TRIGGER is enabled, the device is sampled
+	 * by its data-ready interrupt instead of on demand. Falls back to polling
+	 * if the driver does not support the trigger.
+	 */
+	bool use_trigger;
+	/**
+	 * If CONFIG_APP_QUEUE_BATCHING is enabled, changes of the value are held
+	 * until the next flush, unless the new or the last reported value is
+	 * outside of [urgent_low, urgent_high] - such changes are reported
+	 * immediately. The range is not checked if urgent_low is not less than
+	 * urgent_high, e.g. by default.
+	 */
+	double urgent_low;
+	double urgent_high;
+
+	// managed by sensors.c
+	struct sensor_device_state *device_state;
+	struct sensor_mailbox *mailbox;
+	anjay_oid_t oid;
+	anjay_iid_t iid;
+	bool three_axis;
+	bool installed;
+	avs_time_monotonic_t next_sample;
+#ifdef CONFIG_APP_SENSOR_HUB
+	// sampling interval requested from the sensor hub thread
+	int64_t hub_interval_ms;
+	// see sensors_request_interval()
+	int64_t hub_requested_ms;
+#endif // CONFIG_APP_SENSOR_HUB
+	double reported_values[3];
+	uint32_t suppressed_notifications;
+	// a change exceeding the deadband is held until the next flush
+	bool held;
+#ifdef CONFIG_APP_SENSOR_STATS
+	// aggregated in the current window
+	struct sensor_window_stats window;
+	// published at the end of the previous window
+	struct sensor_window_stats last_window;
+	avs_time_monotonic_t window_end;
+	// fetch time of the last aggregated sample, to aggregate each one once
+	int64_t window_sample_ms;
+#endif // CONFIG_APP_SENSOR_STATS
+};
+
+struct sensor_oid_set {
+	struct sensor_context *sensors;
+	anjay_oid_t oid;
+	size_t sensors_count;
+};
+
+/**
+ * Installs object instances for all configured sensors without accessing the
+ * devices, so that the installation does not delay registration. Devices are
+ * checked for readiness and sampled for the first time by sensors_init_start();
+ * instances of sensors whose devices turn out not to be ready are removed.
+ */
+int sensors_basic_install(anjay_t *anjay, struct sensor_oid_set *oid_sets, size_t oid_sets_count);
+int sensors_three_axis_install(anjay_t *anjay, struct sensor_oid_set *oid_sets,
+			       size_t oid_sets_count);
+
+/**
+ * Initializes devices with the "zephyr,deferred-init" property (on Zephyr 4.0
+ * and later), checks readiness and fetches the first sample of all sensor devices on a dedicated,
+ * low-priority work queue, so that it does not compete with registration.
+ * Also starts the sensor hub thread, if CONFIG_APP_SENSOR_HUB is enabled.
+ */
+void sensors_init_start(void);
+
+/**
+ * Samples every installed sensor whose deadline has passed. Sensors that are
+ * observed by a server are sampled as often as the effective pmin/epmax
+ * attributes of their value resources require; sensors that nobody observes
+ * are not sampled here at all and are only read on demand, unless
+ * CONFIG_APP_SAMPLE_BUFFER is enabled - then they are sampled every
+ * CONFIG_APP_SENSORS_UPDATE_PERIOD_MS and the samples are uploaded using Send.
+ * The same applies to CONFIG_APP_SENSOR_STATS, for which this function also
+ * publishes the statistics of each window once it ends.
+ *
+ * @returns The earliest moment at which this function needs to be called again.
+ */
+avs_time_monotonic_t sensors_update(anjay_t *anjay);
+
+/**
+ * Makes every sensor that is due to be sampled before @p horizon due
+ * immediately, so that it is sampled on the next sensors_update() call.
+ */
+void sensors_expedite(avs_time_monotonic_t horizon);
+
+/**
+ * Reports the changes held back since the previous flush, see
+ * update_scheduler_holding().
+ *
+ * @returns Whether any sensor had a held change.
+ */
+bool sensors_flush_held(anjay_t *anjay);
+
+void sensors_release(void);
+
+/**
+ * Reads the current value(s) of @p sensor without reporting them to Anjay,
+ * from the hub or trigger mailbox if the sensor uses one.
+ *
+ * @param out_values Array of 3 values for three-axis sensors, 1 otherwise.
+ */
+int sensors_read_latest(struct sensor_context *sensor, double *out_values);
+
+/**
+ * Requests @p sensor to be sampled at least every @p interval_ms, regardless
+ * of its observations, for consumers reading it with sensors_sample() at a
+ * higher rate, e.g. the orientation filter. Zero withdraws the request. Only
+ * has an effect with CONFIG_APP_SENSOR_HUB, otherwise sensors_sample() fetches
+ * the device by itself.
+ */
+void sensors_request_interval(struct sensor_context *sensor, int64_t interval_ms);
+
+/**
+ * Reads a new sample of @p sensor, bypassing the sensor cache: fetches the
+ * device, or takes the newest sample published by the hub or trigger mailbox.
+ * Samples from a mailbox may repeat, which the caller tells by the timestamp.
+ *
+ * @param fetch            If false, the device is not fetched, and the values
+ *                         of the last sample fetched by this function are
+ *                         read, e.g. for the second sensor of a single IMU.
+ * @param out_values       Array of 3 values for three-axis sensors, 1 otherwise.
+ * @param out_timestamp_ms Uptime at which the sample was taken.
+ */
+int sensors_sample(struct sensor_context *sensor, bool fetch, double *out_values,
+		   int64_t *out_timestamp_ms);
+
+#ifdef CONFIG_APP_SENSOR_STATS
+double sensor_window_stats_stddev(const struct sensor_window_stats *stats);
+#endif // CONFIG_APP_SENSOR_STATS
+
+size_t sensors_installed_count(void);
+struct sensor_context *sensors_installed_get(size_t index);
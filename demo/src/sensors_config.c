@@ -21,44 +21,57 @@
 #define KPA_TO_PA_FACTOR 1e3
 #define GAUSS_TO_TESLA_FACTOR 1e-4
 
-static struct anjay_zephyr_ipso_sensor_context illuminance_sensor_def[] = {
+static struct sensor_context illuminance_sensor_def[] = {
 #if ILLUMINANCE_AVAILABLE
 	{ .name = "Illuminance",
 	  .unit = "lx",
 	  .device = DEVICE_DT_GET(ILLUMINANCE_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(ILLUMINANCE_NODE),
 	  .channel = SENSOR_CHAN_LIGHT,
+	  .deadband_rel = 0.05,
 	  .min_range_value = NAN,
 	  .max_range_value = NAN }
 #endif // ILLUMINANCE_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context temperature_sensor_def[] = {
+static struct sensor_context temperature_sensor_def[] = {
 #if TEMPERATURE_AVAILABLE
 	{ .name = "Temperature",
 	  .unit = "Cel",
 	  .device = DEVICE_DT_GET(TEMPERATURE_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(TEMPERATURE_NODE),
 	  .channel = SENSOR_CHAN_AMBIENT_TEMP,
+	  .deadband_abs = 0.1,
+	  // frost and overheating are reported without waiting for the batch
+	  .urgent_low = 0.0,
+	  .urgent_high = 45.0,
 	  .min_range_value = NAN,
 	  .max_range_value = NAN }
 #endif // TEMPERATURE_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context humidity_sensor_def[] = {
+static struct sensor_context humidity_sensor_def[] = {
 #if HUMIDITY_AVAILABLE
 	{ .name = "Humidity",
 	  .unit = "%RH",
 	  .device = DEVICE_DT_GET(HUMIDITY_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(HUMIDITY_NODE),
 	  .channel = SENSOR_CHAN_HUMIDITY,
+	  .deadband_abs = 0.5,
+	  // condensation risk
+	  .urgent_low = 0.0,
+	  .urgent_high = 90.0,
 	  .min_range_value = NAN,
 	  .max_range_value = NAN }
 #endif // HUMIDITY_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context acceleration_sensor_def[] = {
+static struct sensor_context acceleration_sensor_def[] = {
 #if ACCELEROMETER_AVAILABLE
 	{ .name = "Accelerometer",
 	  .unit = "m/s2",
 	  .device = DEVICE_DT_GET(ACCELEROMETER_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(ACCELEROMETER_NODE),
 	  .channel = SENSOR_CHAN_ACCEL_XYZ,
 	  .use_y_value = true,
 	  .use_z_value = true,
@@ -67,11 +80,12 @@ static struct anjay_zephyr_ipso_sensor_context acceleration_sensor_def[] = {
 #endif // ACCELEROMETER_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context magnetic_field_sensor_def[] = {
+static struct sensor_context magnetic_field_sensor_def[] = {
 #if MAGNETOMETER_AVAILABLE
 	{ .name = "Magnetometer",
 	  .unit = "T",
 	  .device = DEVICE_DT_GET(MAGNETOMETER_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(MAGNETOMETER_NODE),
 	  .channel = SENSOR_CHAN_MAGN_XYZ,
 	  .scale_factor = GAUSS_TO_TESLA_FACTOR,
 	  .use_y_value = true,
@@ -81,34 +95,39 @@ static struct anjay_zephyr_ipso_sensor_context magnetic_field_sensor_def[] = {
 #endif // MAGNETOMETER_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context pressure_sensor_def[] = {
+static struct sensor_context pressure_sensor_def[] = {
 #if BAROMETER_AVAILABLE
 	{ .name = "Barometer",
 	  .unit = "Pa",
 	  .device = DEVICE_DT_GET(BAROMETER_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(BAROMETER_NODE),
 	  .channel = SENSOR_CHAN_PRESS,
 	  .scale_factor = KPA_TO_PA_FACTOR,
+	  .deadband_abs = 10.0,
 	  .min_range_value = NAN,
 	  .max_range_value = NAN }
 #endif // BAROMETER_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context distance_sensor_def[] = {
+static struct sensor_context distance_sensor_def[] = {
 #if DISTANCE_AVAILABLE
 	{ .name = "Distance",
 	  .unit = "m",
 	  .device = DEVICE_DT_GET(DISTANCE_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(DISTANCE_NODE),
 	  .channel = SENSOR_CHAN_DISTANCE,
+	  .deadband_abs = 0.005,
 	  .min_range_value = NAN,
 	  .max_range_value = NAN }
 #endif // DISTANCE_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_context angular_rate_sensor_def[] = {
+static struct sensor_context angular_rate_sensor_def[] = {
 #if GYROMETER_AVAILABLE
 	{ .name = "Gyrometer",
 	  .unit = "deg/s",
 	  .device = DEVICE_DT_GET(GYROMETER_NODE),
+	  .use_trigger = SENSOR_DRDY_AVAILABLE(GYROMETER_NODE),
 	  .channel = SENSOR_CHAN_GYRO_XYZ,
 	  .use_y_value = true,
 	  .use_z_value = true,
@@ -117,40 +136,38 @@ static struct anjay_zephyr_ipso_sensor_context angular_rate_sensor_def[] = {
 #endif // GYROMETER_AVAILABLE
 };
 
-static struct anjay_zephyr_ipso_sensor_oid_set sensors_basic_oid_def[] = {
-	{ .user_sensors = illuminance_sensor_def,
+static struct sensor_oid_set sensors_basic_oid_def[] = {
+	{ .sensors = illuminance_sensor_def,
 	  .oid = 3301,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(illuminance_sensor_def) },
-	{ .user_sensors = temperature_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(illuminance_sensor_def) },
+	{ .sensors = temperature_sensor_def,
 	  .oid = 3303,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(temperature_sensor_def) },
-	{ .user_sensors = humidity_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(temperature_sensor_def) },
+	{ .sensors = humidity_sensor_def,
 	  .oid = 3304,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(humidity_sensor_def) },
-	{ .user_sensors = pressure_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(humidity_sensor_def) },
+	{ .sensors = pressure_sensor_def,
 	  .oid = 3315,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(pressure_sensor_def) },
-	{ .user_sensors = distance_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(pressure_sensor_def) },
+	{ .sensors = distance_sensor_def,
 	  .oid = 3330,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(distance_sensor_def) }
+	  .sensors_count = AVS_ARRAY_SIZE(distance_sensor_def) }
 };
 
-static struct anjay_zephyr_ipso_sensor_oid_set sensors_3d_oid_def[] = {
-	{ .user_sensors = acceleration_sensor_def,
+static struct sensor_oid_set sensors_3d_oid_def[] = {
+	{ .sensors = acceleration_sensor_def,
 	  .oid = 3313,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(acceleration_sensor_def) },
-	{ .user_sensors = magnetic_field_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(acceleration_sensor_def) },
+	{ .sensors = magnetic_field_sensor_def,
 	  .oid = 3314,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(magnetic_field_sensor_def) },
-	{ .user_sensors = angular_rate_sensor_def,
+	  .sensors_count = AVS_ARRAY_SIZE(magnetic_field_sensor_def) },
+	{ .sensors = angular_rate_sensor_def,
 	  .oid = 3334,
-	  .user_sensors_array_length = AVS_ARRAY_SIZE(angular_rate_sensor_def) }
+	  .sensors_count = AVS_ARRAY_SIZE(angular_rate_sensor_def) }
 };
 
 void sensors_install(anjay_t *anjay)
 {
-	anjay_zephyr_ipso_basic_sensors_install(anjay, sensors_basic_oid_def,
-						AVS_ARRAY_SIZE(sensors_basic_oid_def));
-	anjay_zephyr_ipso_three_axis_sensors_install(anjay, sensors_3d_oid_def,
-						     AVS_ARRAY_SIZE(sensors_3d_oid_def));
+	sensors_basic_install(anjay, sensors_basic_oid_def, AVS_ARRAY_SIZE(sensors_basic_oid_def));
+	sensors_three_axis_install(anjay, sensors_3d_oid_def, AVS_ARRAY_SIZE(sensors_3d_oid_def));
 }
@@ -16,6 +16,6 @@
 
 #pragma once
 
-#include <anjay_zephyr/ipso_objects.h>
+#include "sensors.h"
 
 void sensors_install(anjay_t *anjay);
@@ -18,60 +18,365 @@
 
 #if STATUS_LED_AVAILABLE
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <zephyr/devicetree.h>
-#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+
+#define STATUS_LED_PWM DT_NODE_HAS_COMPAT(DT_PARENT(STATUS_LED_NODE), pwm_leds)
+
+#if STATUS_LED_PWM
+#include <zephyr/drivers/pwm.h>
+#else // STATUS_LED_PWM
+#include <zephyr/drivers/gpio.h>
+#endif // STATUS_LED_PWM
 
 LOG_MODULE_REGISTER(status_led);
 
+#define ERROR_BLINK_ON_MS 200
+#define ERROR_BLINK_OFF_MS 300
+#define ERROR_PAUSE_MS 1500
+
+struct led_step {
+	uint16_t on_ms;
+	uint16_t off_ms;
+};
+
+static const struct led_step heartbeat_steps[] = { { .on_ms = 100, .off_ms = 900 } };
+static const struct led_step connecting_steps[] = { { .on_ms = 250, .off_ms = 250 } };
+static struct led_step error_steps[STATUS_LED_MAX_ERROR_CODE];
+static size_t error_steps_count;
+
+#if STATUS_LED_PWM
+static const struct pwm_dt_spec status_led_spec = PWM_DT_SPEC_GET(STATUS_LED_NODE);
+#else // STATUS_LED_PWM
 static const struct gpio_dt_spec status_led_spec = GPIO_DT_SPEC_GET(STATUS_LED_NODE, gpios);
+#endif // STATUS_LED_PWM
+
+// the pattern state, advanced by the timer; the LED driver is only used by output_work
+static struct k_spinlock lock;
+static struct k_timer step_timer;
+static struct k_work output_work;
+static bool initialized;
+static bool low_power;
+static enum status_led_pattern current_pattern;
+static const struct led_step *steps;
+static size_t steps_count;
+static size_t step_index;
+static bool step_on;
+// LED state to be set by output_work
+static bool output_on;
+static const struct led_step *output_blink;
+static uint32_t pattern_generation;
+
+static void led_set(bool on)
+{
+#if STATUS_LED_PWM
+	pwm_set_pulse_dt(&status_led_spec, on ? status_led_spec.period : 0);
+#else // STATUS_LED_PWM
+	gpio_pin_set_dt(&status_led_spec, on);
+#endif // STATUS_LED_PWM
+}
+
+/**
+ * Lets the PWM peripheral blink the LED on its own, which is possible only for
+ * patterns consisting of a single step.
+ */
+static bool hardware_blink(const struct led_step *step)
+{
+#if STATUS_LED_PWM
+	return !pwm_set_dt(&status_led_spec, PWM_MSEC(step->on_ms + step->off_ms),
+			   PWM_MSEC(step->on_ms));
+#else // STATUS_LED_PWM
+	(void)step;
+	return false;
+#endif // STATUS_LED_PWM
+}
+
+// called with the lock held
+static void start_step(void)
+{
+	const struct led_step *step = &steps[step_index];
+
+	output_on = step_on;
+	k_timer_start(&step_timer, K_MSEC(step_on ? step->on_ms : step->off_ms), K_NO_WAIT);
+	k_work_submit(&output_work);
+}
+
+static void step_timer_expired(struct k_timer *timer)
+{
+	(void)timer;
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (steps_count && !low_power) {
+		if (step_on) {
+			step_on = false;
+		} else {
+			step_index = (step_index + 1) % steps_count;
+			step_on = true;
+		}
+		start_step();
+	}
+	k_spin_unlock(&lock, key);
+}
+
+/**
+ * Applies the state requested last. If the state changes meanwhile, the work
+ * is submitted again, so the LED always ends up in the latest one.
+ */
+static void output_work_handler(struct k_work *work)
+{
+	(void)work;
+
+#if !STATUS_LED_PWM
+	// only accessed by this work item
+	static bool disconnected;
+#endif // !STATUS_LED_PWM
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t generation = pattern_generation;
+	const struct led_step *blink = output_blink;
+	bool on = output_on;
+	bool disconnect = low_power;
+
+	k_spin_unlock(&lock, key);
+
+#if !STATUS_LED_PWM
+	if (disconnected && !disconnect) {
+		gpio_pin_configure_dt(&status_led_spec, GPIO_OUTPUT_INACTIVE);
+		disconnected = false;
+	}
+#endif // !STATUS_LED_PWM
+
+	if (blink) {
+		if (hardware_blink(blink)) {
+			return;
+		}
+
+		// the period is not supported, so the timer blinks the LED instead
+		key = k_spin_lock(&lock);
+		if (generation == pattern_generation) {
+			output_blink = NULL;
+			steps_count = 1;
+			step_index = 0;
+			step_on = true;
+			start_step();
+		}
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	led_set(on);
+
+#if !STATUS_LED_PWM
+	// don't let the pin leak current while the LED is not used
+	if (disconnect && !disconnected) {
+		gpio_pin_configure_dt(&status_led_spec, GPIO_DISCONNECTED);
+		disconnected = true;
+	}
+#endif // !STATUS_LED_PWM
+}
+
+// called with the lock held
+static void apply_pattern(void)
+{
+	k_timer_stop(&step_timer);
+	pattern_generation++;
+	steps = NULL;
+	steps_count = 0;
+	output_blink = NULL;
+	output_on = false;
+
+	if (low_power) {
+		k_work_submit(&output_work);
+		return;
+	}
+
+	switch (current_pattern) {
+	case STATUS_LED_PATTERN_ON:
+	case STATUS_LED_PATTERN_OFF:
+		output_on = current_pattern == STATUS_LED_PATTERN_ON;
+		k_work_submit(&output_work);
+		return;
+
+	case STATUS_LED_PATTERN_HEARTBEAT:
+		steps = heartbeat_steps;
+		steps_count = ARRAY_SIZE(heartbeat_steps);
+		break;
+
+	case STATUS_LED_PATTERN_CONNECTING:
+		steps = connecting_steps;
+		steps_count = ARRAY_SIZE(connecting_steps);
+		break;
+
+	case STATUS_LED_PATTERN_ERROR:
+		steps = error_steps;
+		steps_count = error_steps_count;
+		break;
+	}
+
+	if (STATUS_LED_PWM && steps_count == 1) {
+		// tried by output_work, which falls back to the timer if needed
+		output_blink = &steps[0];
+		steps_count = 0;
+		k_work_submit(&output_work);
+		return;
+	}
+
+	step_index = 0;
+	step_on = true;
+	start_step();
+}
 
 void status_led_init(void)
 {
-	if (!device_is_ready(status_led_spec.port) ||
+#if STATUS_LED_PWM
+	if (!pwm_is_ready_dt(&status_led_spec)) {
+		LOG_WRN("failed to initialize status led");
+		return;
+	}
+#else // STATUS_LED_PWM
+	if (!gpio_is_ready_dt(&status_led_spec) ||
 	    gpio_pin_configure_dt(&status_led_spec, GPIO_OUTPUT_INACTIVE)) {
 		LOG_WRN("failed to initialize status led");
+		return;
+	}
+#endif // STATUS_LED_PWM
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (!initialized) {
+		k_timer_init(&step_timer, step_timer_expired, NULL);
+		k_work_init(&output_work, output_work_handler);
+		initialized = true;
+	}
+	apply_pattern();
+	k_spin_unlock(&lock, key);
+}
+
+void status_led_set_pattern(enum status_led_pattern pattern)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	current_pattern = pattern;
+	if (initialized) {
+		apply_pattern();
 	}
+	k_spin_unlock(&lock, key);
 }
 
-static void status_led_set(int value)
+void status_led_error(uint8_t code)
 {
-	if (device_is_ready(status_led_spec.port)) {
-		gpio_pin_set_dt(&status_led_spec, value);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	code = CLAMP(code, 1, STATUS_LED_MAX_ERROR_CODE);
+	error_steps_count = code;
+	for (size_t i = 0; i < code; i++) {
+		error_steps[i] = (struct led_step){ .on_ms = ERROR_BLINK_ON_MS,
+						    .off_ms = ERROR_BLINK_OFF_MS };
+	}
+	error_steps[code - 1].off_ms = ERROR_PAUSE_MS;
+
+	current_pattern = STATUS_LED_PATTERN_ERROR;
+	if (initialized) {
+		apply_pattern();
 	}
+	k_spin_unlock(&lock, key);
 }
 
-void status_led_on(void)
+void status_led_low_power(bool enable)
 {
-	status_led_set(1);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	low_power = enable;
+	if (initialized) {
+		apply_pattern();
+	}
+	k_spin_unlock(&lock, key);
 }
 
-void status_led_off(void)
+#ifdef CONFIG_SHELL
+static const char *const pattern_names[] = {
+	[STATUS_LED_PATTERN_OFF] = "off",
+	[STATUS_LED_PATTERN_ON] = "on",
+	[STATUS_LED_PATTERN_HEARTBEAT] = "heartbeat",
+	[STATUS_LED_PATTERN_CONNECTING] = "connecting",
+};
+
+static int cmd_status_led_pattern(const struct shell *sh, size_t argc, char **argv)
 {
-	status_led_set(0);
+	(void)argc;
+
+	for (size_t i = 0; i < ARRAY_SIZE(pattern_names); i++) {
+		if (pattern_names[i] && !strcmp(argv[1], pattern_names[i])) {
+			status_led_set_pattern((enum status_led_pattern)i);
+			return 0;
+		}
+	}
+
+	shell_error(sh, "Unknown pattern: %s", argv[1]);
+	return -EINVAL;
 }
 
-void status_led_toggle(void)
+static int cmd_status_led_error(const struct shell *sh, size_t argc, char **argv)
 {
-	if (device_is_ready(status_led_spec.port)) {
-		gpio_pin_toggle_dt(&status_led_spec);
+	(void)argc;
+
+	int code = atoi(argv[1]);
+
+	if (code < 1 || code > STATUS_LED_MAX_ERROR_CODE) {
+		shell_error(sh, "Error code must be in range 1..%d", STATUS_LED_MAX_ERROR_CODE);
+		return -EINVAL;
+	}
+
+	status_led_error((uint8_t)code);
+	return 0;
+}
+
+static int cmd_status_led_low_power(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+
+	if (strcmp(argv[1], "on") && strcmp(argv[1], "off")) {
+		shell_error(sh, "Expected on or off");
+		return -EINVAL;
 	}
+
+	status_led_low_power(!strcmp(argv[1], "on"));
+	return 0;
 }
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_status_led,
+	SHELL_CMD_ARG(pattern, NULL, "Set pattern: off, on, heartbeat or connecting",
+		      cmd_status_led_pattern, 2, 0),
+	SHELL_CMD_ARG(error, NULL, "Blink an error code", cmd_status_led_error, 2, 0),
+	SHELL_CMD_ARG(low_power, NULL, "Turn the low-power mode on or off",
+		      cmd_status_led_low_power, 2, 0),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(status_led, &sub_status_led, "Status LED control", NULL);
+#endif // CONFIG_SHELL
 #else // STATUS_LED_AVAILABLE
 
 void status_led_init(void)
 {
 }
 
-void status_led_on(void)
+void status_led_set_pattern(enum status_led_pattern pattern)
 {
 }
 
-void status_led_off(void)
+void status_led_error(uint8_t code)
 {
 }
 
-void status_led_toggle(void)
+void status_led_low_power(bool enable)
 {
 }
 #endif // STATUS_LED_AVAILABLE
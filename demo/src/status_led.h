@@ -16,15 +16,46 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <zephyr/devicetree.h>
 
 #define STATUS_LED_NODE DT_ALIAS(status_led)
 #define STATUS_LED_AVAILABLE DT_NODE_HAS_STATUS(STATUS_LED_NODE, okay)
 
+enum status_led_pattern {
+	STATUS_LED_PATTERN_OFF,
+	STATUS_LED_PATTERN_ON,
+	// short blink every second
+	STATUS_LED_PATTERN_HEARTBEAT,
+	// fast, even blinking
+	STATUS_LED_PATTERN_CONNECTING,
+	// set with status_led_error()
+	STATUS_LED_PATTERN_ERROR
+};
+
+#define STATUS_LED_MAX_ERROR_CODE 8
+
 void status_led_init(void);
 
-void status_led_on(void);
+/**
+ * Patterns are driven by PWM, if the status-led alias points to a pwm-leds
+ * node and the PWM peripheral supports the period, or by a k_timer otherwise.
+ * Neither requires any activity of the thread that set the pattern. The timer
+ * only advances the pattern, the LED driver is called from the system work
+ * queue.
+ */
+void status_led_set_pattern(enum status_led_pattern pattern);
 
-void status_led_off(void);
+/**
+ * Repeatedly blinks @p code times (up to STATUS_LED_MAX_ERROR_CODE), followed
+ * by a longer pause.
+ */
+void status_led_error(uint8_t code);
 
-void status_led_toggle(void);
+/**
+ * In low-power mode the LED is off and its timer is stopped, regardless of the
+ * pattern. The pattern is restored when the mode is left.
+ */
+void status_led_low_power(bool enable);
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#include <avsystem/commons/avs_sched.h>
+
+#include "peripherals.h"
+#include "switch_events.h"
+
+LOG_MODULE_REGISTER(switch_events);
+
+#define SWITCHES_MAX MAX(SWITCH_COUNT, 1)
+
+static struct gpio_callback callbacks[SWITCHES_MAX];
+static struct k_work_delayable debounce_work;
+
+static K_MUTEX_DEFINE(events_mutex);
+static anjay_t *events_anjay;
+static const anjay_dm_object_def_t **events_switch_obj;
+static avs_sched_handle_t update_handle;
+// update_handle is cleared by the scheduler on the Anjay thread, so the work queue tracks the
+// pending job with this flag instead of reading the handle
+static atomic_t update_pending;
+
+static void update_job(avs_sched_t *sched, const void *unused)
+{
+	(void)sched;
+	(void)unused;
+
+	// cleared before reading the pins, so that an edge handled meanwhile schedules another job
+	atomic_clear(&update_pending);
+	anjay_zephyr_switch_object_update(events_anjay, events_switch_obj);
+}
+
+static void debounce_work_handler(struct k_work *work)
+{
+	(void)work;
+
+	k_mutex_lock(&events_mutex, K_FOREVER);
+	// if the job is still pending, it will read the current state anyway
+	if (events_anjay && atomic_cas(&update_pending, 0, 1) &&
+	    AVS_SCHED_NOW(anjay_get_scheduler(events_anjay), &update_handle, update_job, NULL, 0)) {
+		atomic_clear(&update_pending);
+	}
+	k_mutex_unlock(&events_mutex);
+}
+
+static void switch_edge_handler(const struct device *port, struct gpio_callback *cb,
+				gpio_port_pins_t pins)
+{
+	(void)port;
+	(void)cb;
+	(void)pins;
+
+	// every edge restarts the debounce period
+	k_work_reschedule(&debounce_work, K_MSEC(CONFIG_APP_SWITCH_DEBOUNCE_MS));
+}
+
+int switch_events_init(const struct anjay_zephyr_switch_instance *switches, size_t switches_count)
+{
+	int polled_count = 0;
+
+	k_work_init_delayable(&debounce_work, debounce_work_handler);
+
+	for (size_t i = 0; i < switches_count; i++) {
+		const struct anjay_zephyr_switch_instance *sw = &switches[i];
+
+		if (i >= SWITCHES_MAX || !device_is_ready(sw->device)) {
+			LOG_WRN("Switch %zu is not ready, polling it", i);
+			polled_count++;
+			continue;
+		}
+
+		gpio_init_callback(&callbacks[i], switch_edge_handler, BIT(sw->gpio_pin));
+		if (gpio_add_callback(sw->device, &callbacks[i])) {
+			LOG_WRN("Failed to add callback of switch %zu, polling it", i);
+			polled_count++;
+			continue;
+		}
+		if (gpio_pin_interrupt_configure(sw->device, sw->gpio_pin, GPIO_INT_EDGE_BOTH)) {
+			LOG_WRN("Switch %zu cannot raise interrupts, polling it", i);
+			gpio_remove_callback(sw->device, &callbacks[i]);
+			polled_count++;
+		}
+	}
+
+	return polled_count;
+}
+
+void switch_events_start(anjay_t *anjay, const anjay_dm_object_def_t **switch_obj)
+{
+	k_mutex_lock(&events_mutex, K_FOREVER);
+	events_anjay = anjay;
+	events_switch_obj = switch_obj;
+	// report the state the switches had before interrupts were handled
+	atomic_set(&update_pending, 1);
+	if (AVS_SCHED_NOW(anjay_get_scheduler(anjay), &update_handle, update_job, NULL, 0)) {
+		atomic_clear(&update_pending);
+	}
+	k_mutex_unlock(&events_mutex);
+}
+
+void switch_events_stop(void)
+{
+	k_work_cancel_delayable(&debounce_work);
+
+	k_mutex_lock(&events_mutex, K_FOREVER);
+	avs_sched_del(&update_handle);
+	atomic_clear(&update_pending);
+	events_anjay = NULL;
+	events_switch_obj = NULL;
+	k_mutex_unlock(&events_mutex);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <anjay/anjay.h>
+#include <anjay_zephyr/objects.h>
+
+/**
+ * Configures edge interrupts on the switch pins. After a debounce period
+ * following the last edge, a single Anjay job updates the On/Off switch object,
+ * so that the changes are reported without polling.
+ *
+ * @returns the number of switches whose pins could not be configured to raise
+ *          interrupts, e.g. because their port is not ready. If it is nonzero,
+ *          the object has to be updated periodically as well.
+ */
+int switch_events_init(const struct anjay_zephyr_switch_instance *switches, size_t switches_count);
+
+void switch_events_start(anjay_t *anjay, const anjay_dm_object_def_t **switch_obj);
+void switch_events_stop(void);
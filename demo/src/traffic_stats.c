@@ -0,0 +1,772 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * LwM2M Object: Traffic Statistics
+ * ID: 26245, URN: N/A, Optional, Single
+ *
+ * Bytes and messages sent and received, split by LwM2M operation and by the
+ * object they concern. Multiple resources 0-4 have one instance per operation,
+ * and resources 5-9 one per object, with the same Resource Instance IDs across
+ * the resources of each group.
+ */
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/shell/shell.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_defs.h>
+
+#include "traffic_stats.h"
+
+/**
+ * Operation Name: R, Multiple, Mandatory
+ * type: string, range: N/A, unit: N/A
+ */
+#define RID_OPERATION_NAME 0
+
+/**
+ * Operation Sent Bytes: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_OPERATION_TX_BYTES 1
+
+/**
+ * Operation Sent Messages: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ */
+#define RID_OPERATION_TX_MESSAGES 2
+
+/**
+ * Operation Received Bytes: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_OPERATION_RX_BYTES 3
+
+/**
+ * Operation Received Messages: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ */
+#define RID_OPERATION_RX_MESSAGES 4
+
+/**
+ * Object ID: R, Multiple, Mandatory
+ * type: integer, range: 0..65534, unit: N/A
+ */
+#define RID_OBJECT_ID 5
+
+/**
+ * Object Sent Bytes: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_OBJECT_TX_BYTES 6
+
+/**
+ * Object Sent Messages: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ */
+#define RID_OBJECT_TX_MESSAGES 7
+
+/**
+ * Object Received Bytes: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: B
+ */
+#define RID_OBJECT_RX_BYTES 8
+
+/**
+ * Object Received Messages: R, Multiple, Mandatory
+ * type: integer, range: N/A, unit: N/A
+ */
+#define RID_OBJECT_RX_MESSAGES 9
+
+/**
+ * Reset: E, Single, Mandatory
+ * type: N/A, range: N/A, unit: N/A
+ * Resets all the counters.
+ */
+#define RID_RESET 10
+
+#define COAP_VERSION 1
+#define COAP_MAX_TOKEN_LEN 8
+#define COAP_PAYLOAD_MARKER 0xFF
+
+#define COAP_TYPE_RST 3
+
+#define COAP_CODE_CLASS(code) ((code) >> 5)
+#define COAP_CODE_EMPTY 0x00
+#define COAP_CODE_GET 0x01
+#define COAP_CODE_POST 0x02
+#define COAP_CODE_PUT 0x03
+#define COAP_CODE_DELETE 0x04
+#define COAP_CODE_FETCH 0x05
+
+#define COAP_OPTION_OBSERVE 6
+#define COAP_OPTION_URI_PATH 11
+#define COAP_OPTION_BLOCK1 27
+
+#define COAP_OBSERVE_REGISTER 0
+
+// enough to tell "rd" and "dp" apart from numeric object IDs
+#define PATH_SEGMENT_MAX_LEN 5
+#define PATH_SEGMENTS_MAX 3
+
+#define FIRMWARE_UPDATE_OID 5
+#define ADVANCED_FIRMWARE_UPDATE_OID 33629
+
+// exchanges whose responses, notifications and ACKs are still expected: all
+// the observations, plus the short-lived exchanges of other requests
+#define EXCHANGES_MAX (CONFIG_APP_TRAFFIC_STATS_MAX_OBSERVATIONS + 8)
+#define OBJECTS_MAX CONFIG_APP_TRAFFIC_STATS_MAX_OBJECTS
+
+struct coap_message {
+	uint8_t type;
+	uint8_t code;
+	uint16_t message_id;
+	uint8_t token[COAP_MAX_TOKEN_LEN];
+	uint8_t token_len;
+	bool has_observe;
+	uint32_t observe;
+	bool has_block1;
+	char path[PATH_SEGMENTS_MAX][PATH_SEGMENT_MAX_LEN + 1];
+	size_t path_count;
+};
+
+struct exchange {
+	uint8_t token[COAP_MAX_TOKEN_LEN];
+	uint8_t token_len;
+	// of the last message, to match empty ACKs and Resets
+	uint16_t message_id;
+	enum traffic_op op;
+	// -1 if the exchange does not concern a single object
+	int32_t oid;
+	// used to evict the least recently used exchange
+	uint32_t last_used;
+	// not evicted until cancelled, so that late notifications keep their object
+	bool observed;
+};
+
+struct object_counters {
+	anjay_oid_t oid;
+	struct traffic_counters counters;
+};
+
+static const char *const op_names[] = {
+	[TRAFFIC_OP_REGISTER] = "Register",     [TRAFFIC_OP_UPDATE] = "Update",
+	[TRAFFIC_OP_DEREGISTER] = "Deregister", [TRAFFIC_OP_BOOTSTRAP] = "Bootstrap",
+	[TRAFFIC_OP_NOTIFY] = "Notify",         [TRAFFIC_OP_SEND] = "Send",
+	[TRAFFIC_OP_READ] = "Read",             [TRAFFIC_OP_OBSERVE] = "Observe",
+	[TRAFFIC_OP_WRITE] = "Write",           [TRAFFIC_OP_EXECUTE] = "Execute",
+	[TRAFFIC_OP_FOTA_BLOCK] = "FOTA block", [TRAFFIC_OP_OTHER] = "Other",
+	[TRAFFIC_OP_UNPARSED] = "Unparsed"
+};
+
+BUILD_ASSERT(ARRAY_SIZE(op_names) == TRAFFIC_OP_COUNT);
+
+// datagrams may be sent and received by different threads
+static struct k_spinlock lock;
+static struct traffic_counters op_counters[TRAFFIC_OP_COUNT];
+static struct object_counters object_counters[OBJECTS_MAX];
+static size_t object_counters_count;
+static struct exchange exchanges[EXCHANGES_MAX];
+static uint32_t use_counter;
+
+static int read_extended(const uint8_t *data, size_t len, size_t *pos, uint32_t *value)
+{
+	if (*value == 13) {
+		if (*pos + 1 > len) {
+			return -1;
+		}
+		*value = 13 + data[*pos];
+		*pos += 1;
+	} else if (*value == 14) {
+		if (*pos + 2 > len) {
+			return -1;
+		}
+		*value = 269 + ((uint32_t)data[*pos] << 8 | data[*pos + 1]);
+		*pos += 2;
+	} else if (*value == 15) {
+		return -1;
+	}
+	return 0;
+}
+
+static void parse_option(struct coap_message *msg, uint32_t number, const uint8_t *value,
+			 size_t len)
+{
+	switch (number) {
+	case COAP_OPTION_OBSERVE:
+		msg->has_observe = true;
+		msg->observe = 0;
+		for (size_t i = 0; i < len; i++) {
+			msg->observe = msg->observe << 8 | value[i];
+		}
+		break;
+
+	case COAP_OPTION_URI_PATH:
+		if (msg->path_count < PATH_SEGMENTS_MAX) {
+			size_t copied = MIN(len, PATH_SEGMENT_MAX_LEN);
+
+			memcpy(msg->path[msg->path_count], value, copied);
+			msg->path[msg->path_count][copied] = '\0';
+		}
+		msg->path_count++;
+		break;
+
+	case COAP_OPTION_BLOCK1:
+		msg->has_block1 = true;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ * Parses the header and the options of a CoAP over UDP message (RFC 7252).
+ */
+static int parse_coap(const uint8_t *data, size_t len, struct coap_message *msg)
+{
+	memset(msg, 0, sizeof(*msg));
+	if (len < 4 || data[0] >> 6 != COAP_VERSION) {
+		return -1;
+	}
+
+	msg->type = (data[0] >> 4) & 0x3;
+	msg->token_len = data[0] & 0xF;
+	msg->code = data[1];
+	msg->message_id = (uint16_t)(data[2] << 8 | data[3]);
+	if (msg->token_len > COAP_MAX_TOKEN_LEN || len < 4 + (size_t)msg->token_len) {
+		return -1;
+	}
+	memcpy(msg->token, &data[4], msg->token_len);
+
+	size_t pos = 4 + msg->token_len;
+	uint32_t number = 0;
+
+	while (pos < len && data[pos] != COAP_PAYLOAD_MARKER) {
+		uint32_t delta = data[pos] >> 4;
+		uint32_t option_len = data[pos] & 0xF;
+
+		pos++;
+		if (read_extended(data, len, &pos, &delta) ||
+		    read_extended(data, len, &pos, &option_len) || pos + option_len > len) {
+			return -1;
+		}
+		number += delta;
+		parse_option(msg, number, &data[pos], option_len);
+		pos += option_len;
+	}
+	return 0;
+}
+
+static int32_t path_oid(const struct coap_message *msg)
+{
+	if (msg->path_count == 0 || !msg->path[0][0]) {
+		return -1;
+	}
+
+	int32_t oid = 0;
+
+	for (const char *c = msg->path[0]; *c; c++) {
+		if (*c < '0' || *c > '9') {
+			return -1;
+		}
+		oid = 10 * oid + (*c - '0');
+	}
+	return oid < ANJAY_ID_INVALID ? oid : -1;
+}
+
+// requests sent by the client, i.e. the Registration and Reporting interfaces
+static enum traffic_op classify_outgoing_request(const struct coap_message *msg)
+{
+	if (msg->path_count > 0 && !strcmp(msg->path[0], "rd")) {
+		if (msg->code == COAP_CODE_DELETE) {
+			return TRAFFIC_OP_DEREGISTER;
+		}
+		return msg->path_count == 1 ? TRAFFIC_OP_REGISTER : TRAFFIC_OP_UPDATE;
+	}
+	if (msg->path_count > 0 && !strcmp(msg->path[0], "bs")) {
+		return TRAFFIC_OP_BOOTSTRAP;
+	}
+	if (msg->path_count > 0 && !strcmp(msg->path[0], "dp")) {
+		return TRAFFIC_OP_SEND;
+	}
+	// firmware downloads in the pull mode are the only other requests
+	return msg->code == COAP_CODE_GET ? TRAFFIC_OP_FOTA_BLOCK : TRAFFIC_OP_OTHER;
+}
+
+// requests sent by the server, i.e. the Device Management interface
+static enum traffic_op classify_incoming_request(const struct coap_message *msg, int32_t oid)
+{
+	if (msg->has_block1 &&
+	    (oid == FIRMWARE_UPDATE_OID || oid == ADVANCED_FIRMWARE_UPDATE_OID)) {
+		return TRAFFIC_OP_FOTA_BLOCK;
+	}
+
+	switch (msg->code) {
+	case COAP_CODE_GET:
+	case COAP_CODE_FETCH:
+		if (msg->has_observe && msg->observe == COAP_OBSERVE_REGISTER) {
+			return TRAFFIC_OP_OBSERVE;
+		}
+		return TRAFFIC_OP_READ;
+	case COAP_CODE_PUT:
+		return TRAFFIC_OP_WRITE;
+	case COAP_CODE_POST:
+		// only Execute targets a resource, i.e. /oid/iid/rid
+		return msg->path_count == 3 ? TRAFFIC_OP_EXECUTE : TRAFFIC_OP_WRITE;
+	default:
+		return TRAFFIC_OP_OTHER;
+	}
+}
+
+static struct exchange *find_exchange_by_token(const struct coap_message *msg)
+{
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(exchanges); i++) {
+		if (exchanges[i].last_used && exchanges[i].token_len == msg->token_len &&
+		    !memcmp(exchanges[i].token, msg->token, msg->token_len)) {
+			return &exchanges[i];
+		}
+	}
+	return NULL;
+}
+
+static struct exchange *find_exchange_by_message_id(uint16_t message_id)
+{
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(exchanges); i++) {
+		if (exchanges[i].last_used && exchanges[i].message_id == message_id) {
+			return &exchanges[i];
+		}
+	}
+	return NULL;
+}
+
+// observations are evicted only if there are more of them than expected
+static bool evicts_before(const struct exchange *candidate, const struct exchange *exchange)
+{
+	if (candidate->observed != exchange->observed) {
+		return !candidate->observed;
+	}
+	return candidate->last_used < exchange->last_used;
+}
+
+static struct exchange *add_exchange(const struct coap_message *msg)
+{
+	struct exchange *exchange = find_exchange_by_token(msg);
+
+	if (!exchange) {
+		exchange = &exchanges[0];
+		for (size_t i = 1; i < AVS_ARRAY_SIZE(exchanges); i++) {
+			if (evicts_before(&exchanges[i], exchange)) {
+				exchange = &exchanges[i];
+			}
+		}
+		memcpy(exchange->token, msg->token, msg->token_len);
+		exchange->token_len = msg->token_len;
+		exchange->observed = false;
+	}
+	return exchange;
+}
+
+// a new registration implicitly cancels all the observations
+static void cancel_observations(void)
+{
+	for (size_t i = 0; i < AVS_ARRAY_SIZE(exchanges); i++) {
+		exchanges[i].observed = false;
+	}
+}
+
+static void touch_exchange(struct exchange *exchange, const struct coap_message *msg)
+{
+	exchange->message_id = msg->message_id;
+	exchange->last_used = ++use_counter;
+}
+
+static void classify(const struct coap_message *msg, bool outgoing, enum traffic_op *out_op,
+		     int32_t *out_oid)
+{
+	struct exchange *exchange;
+
+	*out_op = TRAFFIC_OP_OTHER;
+	*out_oid = -1;
+
+	if (msg->code == COAP_CODE_EMPTY) {
+		// ACKs and Resets belong to the exchange of the acknowledged message
+		exchange = find_exchange_by_message_id(msg->message_id);
+	} else if (COAP_CODE_CLASS(msg->code) == 0) {
+		int32_t oid = outgoing ? -1 : path_oid(msg);
+
+		exchange = add_exchange(msg);
+		exchange->op = outgoing ? classify_outgoing_request(msg)
+					: classify_incoming_request(msg, oid);
+		exchange->oid = exchange->op == TRAFFIC_OP_FOTA_BLOCK && outgoing
+					? FIRMWARE_UPDATE_OID
+					: oid;
+		// a GET with Observe set to 1 on the same token cancels the observation
+		exchange->observed = exchange->op == TRAFFIC_OP_OBSERVE;
+		if (exchange->op == TRAFFIC_OP_REGISTER) {
+			cancel_observations();
+		}
+	} else {
+		exchange = find_exchange_by_token(msg);
+		if (exchange) {
+			*out_op = exchange->op;
+			*out_oid = exchange->oid;
+			// responses to Observe that follow the first one are notifications
+			if (exchange->op == TRAFFIC_OP_OBSERVE) {
+				exchange->op = TRAFFIC_OP_NOTIFY;
+			}
+			// a response without Observe, e.g. an error, ends the observation
+			if (!msg->has_observe) {
+				exchange->observed = false;
+			}
+			touch_exchange(exchange, msg);
+			return;
+		}
+		if (outgoing && msg->has_observe) {
+			*out_op = TRAFFIC_OP_NOTIFY;
+		}
+	}
+
+	if (exchange) {
+		*out_op = exchange->op;
+		*out_oid = exchange->oid;
+		// the server rejects a notification with a Reset to cancel the observation
+		if (msg->type == COAP_TYPE_RST) {
+			exchange->observed = false;
+		}
+		touch_exchange(exchange, msg);
+	}
+}
+
+static void add_counters(struct traffic_counters *counters, size_t len, bool outgoing)
+{
+	if (outgoing) {
+		counters->tx_bytes += len;
+		counters->tx_messages++;
+	} else {
+		counters->rx_bytes += len;
+		counters->rx_messages++;
+	}
+}
+
+static struct object_counters *get_object_counters(anjay_oid_t oid)
+{
+	for (size_t i = 0; i < object_counters_count; i++) {
+		if (object_counters[i].oid == oid) {
+			return &object_counters[i];
+		}
+	}
+
+	if (object_counters_count >= AVS_ARRAY_SIZE(object_counters)) {
+		return NULL;
+	}
+
+	struct object_counters *result = &object_counters[object_counters_count++];
+
+	memset(result, 0, sizeof(*result));
+	result->oid = oid;
+	return result;
+}
+
+void traffic_stats_record(const uint8_t *datagram, size_t len, bool outgoing)
+{
+	struct coap_message msg;
+	enum traffic_op op = TRAFFIC_OP_UNPARSED;
+	int32_t oid = -1;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (!parse_coap(datagram, len, &msg)) {
+		classify(&msg, outgoing, &op, &oid);
+	}
+
+	add_counters(&op_counters[op], len, outgoing);
+	if (oid >= 0) {
+		struct object_counters *counters = get_object_counters((anjay_oid_t)oid);
+
+		if (counters) {
+			add_counters(&counters->counters, len, outgoing);
+		}
+	}
+	k_spin_unlock(&lock, key);
+}
+
+const char *traffic_stats_op_name(enum traffic_op op)
+{
+	return op_names[op];
+}
+
+void traffic_stats_get_op(enum traffic_op op, struct traffic_counters *out_counters)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*out_counters = op_counters[op];
+	k_spin_unlock(&lock, key);
+}
+
+int traffic_stats_get_object(size_t index, anjay_oid_t *out_oid,
+			     struct traffic_counters *out_counters)
+{
+	int result = -ENOENT;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (index < object_counters_count) {
+		*out_oid = object_counters[index].oid;
+		*out_counters = object_counters[index].counters;
+		result = 0;
+	}
+	k_spin_unlock(&lock, key);
+	return result;
+}
+
+void traffic_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	// the exchanges are kept, so that ongoing ones are still classified
+	memset(op_counters, 0, sizeof(op_counters));
+	object_counters_count = 0;
+	k_spin_unlock(&lock, key);
+}
+
+/**
+ * Every datagram sent or received by Anjay, including DTLS offloaded to the
+ * modem, passes through these calls. The wrappers are enabled with the --wrap
+ * linker option in CMakeLists.txt.
+ */
+ssize_t __real_z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
+				   const struct sockaddr *dest_addr, socklen_t addrlen);
+ssize_t __real_z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+				     struct sockaddr *src_addr, socklen_t *addrlen);
+
+ssize_t __wrap_z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
+				   const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	ssize_t result = __real_z_impl_zsock_sendto(sock, buf, len, flags, dest_addr, addrlen);
+
+	if (result > 0) {
+		traffic_stats_record(buf, (size_t)result, true);
+	}
+	return result;
+}
+
+ssize_t __wrap_z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+				     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	ssize_t result = __real_z_impl_zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
+
+	// peeked datagrams are accounted once they are actually received
+	if (result > 0 && !(flags & ZSOCK_MSG_PEEK)) {
+		traffic_stats_record(buf, (size_t)result, false);
+	}
+	return result;
+}
+
+static int list_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+
+	anjay_dm_emit(ctx, 0);
+	return 0;
+}
+
+static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	for (anjay_rid_t rid = RID_OPERATION_NAME; rid <= RID_OBJECT_RX_MESSAGES; rid++) {
+		anjay_dm_emit_res(ctx, rid, ANJAY_DM_RES_RM, ANJAY_DM_RES_PRESENT);
+	}
+	anjay_dm_emit_res(ctx, RID_RESET, ANJAY_DM_RES_E, ANJAY_DM_RES_PRESENT);
+	return 0;
+}
+
+static int list_resource_instances(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+				   anjay_iid_t iid, anjay_rid_t rid, anjay_dm_list_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	if (rid < RID_OBJECT_ID) {
+		for (size_t i = 0; i < TRAFFIC_OP_COUNT; i++) {
+			anjay_dm_emit(ctx, (anjay_riid_t)i);
+		}
+		return 0;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	size_t count = object_counters_count;
+
+	k_spin_unlock(&lock, key);
+	for (size_t i = 0; i < count; i++) {
+		anjay_dm_emit(ctx, (anjay_riid_t)i);
+	}
+	return 0;
+}
+
+static int ret_counter(anjay_output_ctx_t *ctx, const struct traffic_counters *counters,
+		       anjay_rid_t offset)
+{
+	switch (offset) {
+	case 0:
+		return anjay_ret_i64(ctx, (int64_t)counters->tx_bytes);
+	case 1:
+		return anjay_ret_i64(ctx, counters->tx_messages);
+	case 2:
+		return anjay_ret_i64(ctx, (int64_t)counters->rx_bytes);
+	default:
+		return anjay_ret_i64(ctx, counters->rx_messages);
+	}
+}
+
+static int resource_read(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			 anjay_iid_t iid, anjay_rid_t rid, anjay_riid_t riid,
+			 anjay_output_ctx_t *ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+
+	struct traffic_counters counters;
+	anjay_oid_t oid;
+
+	if (rid <= RID_OPERATION_RX_MESSAGES) {
+		assert(riid < TRAFFIC_OP_COUNT);
+		if (rid == RID_OPERATION_NAME) {
+			return anjay_ret_string(ctx, traffic_stats_op_name((enum traffic_op)riid));
+		}
+		traffic_stats_get_op((enum traffic_op)riid, &counters);
+		return ret_counter(ctx, &counters, rid - RID_OPERATION_TX_BYTES);
+	}
+
+	if (rid <= RID_OBJECT_RX_MESSAGES) {
+		// the counters may have been reset since the instances were listed
+		if (traffic_stats_get_object(riid, &oid, &counters)) {
+			return ANJAY_ERR_NOT_FOUND;
+		}
+		if (rid == RID_OBJECT_ID) {
+			return anjay_ret_i32(ctx, oid);
+		}
+		return ret_counter(ctx, &counters, rid - RID_OBJECT_TX_BYTES);
+	}
+
+	return ANJAY_ERR_METHOD_NOT_ALLOWED;
+}
+
+static int resource_execute(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
+			    anjay_iid_t iid, anjay_rid_t rid, anjay_execute_ctx_t *arg_ctx)
+{
+	(void)anjay;
+	(void)obj_ptr;
+	(void)iid;
+	(void)arg_ctx;
+
+	switch (rid) {
+	case RID_RESET:
+		traffic_stats_reset();
+		return 0;
+
+	default:
+		return ANJAY_ERR_METHOD_NOT_ALLOWED;
+	}
+}
+
+static const anjay_dm_object_def_t OBJ_DEF = {
+	.oid = 26245,
+	.handlers = { .list_instances = list_instances,
+		      .list_resources = list_resources,
+		      .list_resource_instances = list_resource_instances,
+		      .resource_read = resource_read,
+		      .resource_execute = resource_execute }
+};
+
+static const anjay_dm_object_def_t *obj_def_ptr = &OBJ_DEF;
+
+const anjay_dm_object_def_t **traffic_stats_object_create(void)
+{
+	return &obj_def_ptr;
+}
+
+void traffic_stats_object_release(const anjay_dm_object_def_t **def)
+{
+	(void)def;
+}
+
+#ifdef CONFIG_SHELL
+static void print_counters(const struct shell *sh, const char *label,
+			   const struct traffic_counters *counters)
+{
+	shell_print(sh, "%-12s %10llu %8u %10llu %8u", label,
+		    (unsigned long long)counters->tx_bytes, counters->tx_messages,
+		    (unsigned long long)counters->rx_bytes, counters->rx_messages);
+}
+
+static int cmd_traffic_show(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	struct traffic_counters counters;
+	anjay_oid_t oid;
+	char label[8];
+
+	shell_print(sh, "%-12s %10s %8s %10s %8s", "operation", "tx [B]", "tx msgs", "rx [B]",
+		    "rx msgs");
+	for (size_t i = 0; i < TRAFFIC_OP_COUNT; i++) {
+		traffic_stats_get_op((enum traffic_op)i, &counters);
+		print_counters(sh, traffic_stats_op_name((enum traffic_op)i), &counters);
+	}
+
+	shell_print(sh, "");
+	shell_print(sh, "%-12s %10s %8s %10s %8s", "object", "tx [B]", "tx msgs", "rx [B]",
+		    "rx msgs");
+	for (size_t i = 0; !traffic_stats_get_object(i, &oid, &counters); i++) {
+		snprintf(label, sizeof(label), "/%u", oid);
+		print_counters(sh, label, &counters);
+	}
+	return 0;
+}
+
+static int cmd_traffic_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	(void)argc;
+	(void)argv;
+
+	traffic_stats_reset();
+	shell_print(sh, "Statistics reset");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_traffic,
+			       SHELL_CMD(show, NULL, "Show traffic per operation and object",
+					 cmd_traffic_show),
+			       SHELL_CMD(reset, NULL, "Reset traffic statistics",
+					 cmd_traffic_reset),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(traffic, &sub_traffic, "LwM2M traffic statistics", NULL);
+#endif // CONFIG_SHELL
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <anjay/dm.h>
+
+#ifdef CONFIG_APP_TRAFFIC_STATS
+
+enum traffic_op {
+	TRAFFIC_OP_REGISTER,
+	TRAFFIC_OP_UPDATE,
+	TRAFFIC_OP_DEREGISTER,
+	TRAFFIC_OP_BOOTSTRAP,
+	TRAFFIC_OP_NOTIFY,
+	TRAFFIC_OP_SEND,
+	TRAFFIC_OP_READ,
+	TRAFFIC_OP_OBSERVE,
+	TRAFFIC_OP_WRITE,
+	TRAFFIC_OP_EXECUTE,
+	TRAFFIC_OP_FOTA_BLOCK,
+	// other requests, empty messages and unmatched responses
+	TRAFFIC_OP_OTHER,
+	// datagrams that are not plaintext CoAP, e.g. DTLS records
+	TRAFFIC_OP_UNPARSED,
+	TRAFFIC_OP_COUNT
+};
+
+struct traffic_counters {
+	uint64_t tx_bytes;
+	uint32_t tx_messages;
+	uint64_t rx_bytes;
+	uint32_t rx_messages;
+};
+
+/**
+ * Accounts a datagram sent or received on any socket. Called from the socket
+ * call wrappers, so it is not necessary to call it from the application.
+ */
+void traffic_stats_record(const uint8_t *datagram, size_t len, bool outgoing);
+
+const char *traffic_stats_op_name(enum traffic_op op);
+void traffic_stats_get_op(enum traffic_op op, struct traffic_counters *out_counters);
+
+/**
+ * @returns 0 and fills the counters of the @p index-th object that traffic
+ *          has been accounted to, or -ENOENT if there are fewer objects.
+ */
+int traffic_stats_get_object(size_t index, anjay_oid_t *out_oid,
+			     struct traffic_counters *out_counters);
+
+void traffic_stats_reset(void);
+
+const anjay_dm_object_def_t **traffic_stats_object_create(void);
+void traffic_stats_object_release(const anjay_dm_object_def_t **def);
+
+#endif // CONFIG_APP_TRAFFIC_STATS
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+
+#include <zephyr/logging/log.h>
+
+#include <avsystem/commons/avs_defs.h>
+#include <avsystem/commons/avs_sched.h>
+
+#include "benchmark.h"
+#include "perf_stats.h"
+#include "update_scheduler.h"
+
+LOG_MODULE_REGISTER(update_scheduler);
+
+static struct update_task *tasks[UPDATE_SCHEDULER_MAX_TASKS];
+static size_t tasks_count;
+
+static anjay_t *scheduler_anjay;
+static avs_sched_handle_t wakeup_handle;
+static uint32_t wakeup_count;
+
+#ifdef CONFIG_APP_QUEUE_BATCHING
+#define HELD_NOTIFICATIONS_MAX 32
+
+struct held_notification {
+	anjay_oid_t oid;
+	anjay_iid_t iid;
+	anjay_rid_t rid;
+};
+
+static struct held_notification held[HELD_NOTIFICATIONS_MAX];
+static size_t held_count;
+#endif // CONFIG_APP_QUEUE_BATCHING
+
+static void wakeup(avs_sched_t *sched, const void *anjay_ptr);
+
+static void arm(void)
+{
+	if (!scheduler_anjay) {
+		return;
+	}
+
+	avs_time_monotonic_t earliest = AVS_TIME_MONOTONIC_INVALID;
+
+	for (size_t i = 0; i < tasks_count; i++) {
+		if (avs_time_monotonic_valid(tasks[i]->deadline) &&
+		    (!avs_time_monotonic_valid(earliest) ||
+		     avs_time_monotonic_before(tasks[i]->deadline, earliest))) {
+			earliest = tasks[i]->deadline;
+		}
+	}
+
+	avs_sched_del(&wakeup_handle);
+	if (avs_time_monotonic_valid(earliest)) {
+		AVS_SCHED_AT(anjay_get_scheduler(scheduler_anjay), &wakeup_handle, earliest, wakeup,
+			     &scheduler_anjay, sizeof(scheduler_anjay));
+	}
+}
+
+static void wakeup(avs_sched_t *sched, const void *anjay_ptr)
+{
+	(void)sched;
+
+	anjay_t *anjay = *(anjay_t *const *)anjay_ptr;
+	avs_time_monotonic_t now = avs_time_monotonic_now();
+
+	wakeup_count++;
+	benchmark_cycle_begin();
+
+	for (size_t i = 0; i < tasks_count; i++) {
+		struct update_task *task = tasks[i];
+
+		if (!avs_time_monotonic_valid(task->deadline) ||
+		    avs_time_monotonic_before(now, task->deadline)) {
+			continue;
+		}
+
+		if (avs_time_duration_valid(task->period)) {
+			task->deadline = avs_time_monotonic_add(task->deadline, task->period);
+			// don't try to catch up on missed runs
+			if (avs_time_monotonic_before(task->deadline, now)) {
+				task->deadline = avs_time_monotonic_add(now, task->period);
+			}
+		} else {
+			task->deadline = AVS_TIME_MONOTONIC_INVALID;
+		}
+
+		// may move its own deadline with update_scheduler_set_deadline()
+		PERF_STATS_TIMED(task->name, task->run(anjay));
+	}
+
+	arm();
+	benchmark_cycle_end();
+}
+
+#ifdef CONFIG_APP_QUEUE_BATCHING
+static bool hold(anjay_oid_t oid, anjay_iid_t iid, anjay_rid_t rid)
+{
+	for (size_t i = 0; i < held_count; i++) {
+		if (held[i].oid == oid && held[i].iid == iid && held[i].rid == rid) {
+			return true;
+		}
+	}
+
+	if (held_count >= AVS_ARRAY_SIZE(held)) {
+		return false;
+	}
+
+	held[held_count++] = (struct held_notification){ .oid = oid, .iid = iid, .rid = rid };
+	return true;
+}
+
+static void flush(anjay_t *anjay)
+{
+	bool changed = held_count > 0;
+
+	for (size_t i = 0; i < tasks_count; i++) {
+		if (tasks[i]->flush) {
+			changed = tasks[i]->flush(anjay) || changed;
+		}
+	}
+
+	if (!changed) {
+		// nothing to send, the next Update is left to Anjay
+		return;
+	}
+
+	// scheduled first, so that the Update opens the session in queue mode and
+	// the notifications follow it
+	if (anjay_schedule_registration_update(anjay, ANJAY_SSID_ANY)) {
+		LOG_WRN("Could not schedule Registration Update");
+	}
+	for (size_t i = 0; i < held_count; i++) {
+		anjay_notify_changed(anjay, held[i].oid, held[i].iid, held[i].rid);
+	}
+	LOG_DBG("Flushed %zu held notifications", held_count);
+	held_count = 0;
+}
+
+static struct update_task flush_task = { .name = "flush", .run = flush };
+#endif // CONFIG_APP_QUEUE_BATCHING
+
+int update_scheduler_add(struct update_task *task)
+{
+	assert(task && task->run);
+
+	if (tasks_count >= AVS_ARRAY_SIZE(tasks)) {
+		LOG_ERR("Could not add task %s: too many tasks", task->name);
+		return -1;
+	}
+
+	task->deadline = avs_time_monotonic_now();
+	tasks[tasks_count++] = task;
+	perf_stats_register(task->name);
+	arm();
+
+	return 0;
+}
+
+void update_scheduler_set_deadline(struct update_task *task, avs_time_monotonic_t deadline)
+{
+	task->deadline = deadline;
+	arm();
+}
+
+bool update_scheduler_holding(void)
+{
+#ifdef CONFIG_APP_QUEUE_BATCHING
+	return scheduler_anjay != NULL;
+#else  // CONFIG_APP_QUEUE_BATCHING
+	return false;
+#endif // CONFIG_APP_QUEUE_BATCHING
+}
+
+void update_scheduler_notify_changed(anjay_t *anjay, anjay_oid_t oid, anjay_iid_t iid,
+				     anjay_rid_t rid, bool urgent)
+{
+#ifdef CONFIG_APP_QUEUE_BATCHING
+	if (update_scheduler_holding()) {
+		// if there is no room left, the notification is not held
+		if (!urgent && hold(oid, iid, rid)) {
+			return;
+		}
+		update_scheduler_flush_soon();
+	}
+#else  // CONFIG_APP_QUEUE_BATCHING
+	(void)urgent;
+#endif // CONFIG_APP_QUEUE_BATCHING
+	anjay_notify_changed(anjay, oid, iid, rid);
+}
+
+void update_scheduler_flush_soon(void)
+{
+#ifdef CONFIG_APP_QUEUE_BATCHING
+	if (update_scheduler_holding()) {
+		update_scheduler_set_deadline(&flush_task, avs_time_monotonic_now());
+	}
+#endif // CONFIG_APP_QUEUE_BATCHING
+}
+
+void update_scheduler_start(anjay_t *anjay)
+{
+#ifdef CONFIG_APP_QUEUE_BATCHING
+	avs_time_duration_t period =
+		avs_time_duration_from_scalar(CONFIG_APP_QUEUE_BATCHING_PERIOD_S, AVS_TIME_S);
+
+	flush_task.period = period;
+	held_count = 0;
+	update_scheduler_add(&flush_task);
+	// the Register itself opens the first session
+	flush_task.deadline = avs_time_monotonic_add(avs_time_monotonic_now(), period);
+#endif // CONFIG_APP_QUEUE_BATCHING
+
+	scheduler_anjay = anjay;
+	arm();
+}
+
+void update_scheduler_stop(void)
+{
+	avs_sched_del(&wakeup_handle);
+	scheduler_anjay = NULL;
+	tasks_count = 0;
+#ifdef CONFIG_APP_QUEUE_BATCHING
+	held_count = 0;
+#endif // CONFIG_APP_QUEUE_BATCHING
+}
+
+uint32_t update_scheduler_wakeup_count(void)
+{
+	return wakeup_count;
+}
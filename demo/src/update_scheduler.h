@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <anjay/anjay.h>
+#include <avsystem/commons/avs_time.h>
+
+#define UPDATE_SCHEDULER_MAX_TASKS 12
+
+struct update_task {
+	const char *name;
+	void (*run)(anjay_t *anjay);
+	/**
+	 * Interval between consecutive runs. If invalid, the task is only run
+	 * when its deadline is set explicitly with update_scheduler_set_deadline().
+	 */
+	avs_time_duration_t period;
+	/**
+	 * Optional. If CONFIG_APP_QUEUE_BATCHING is enabled, called when the held
+	 * notifications are flushed, to report the changes the task held back.
+	 *
+	 * @returns Whether any change has been reported.
+	 */
+	bool (*flush)(anjay_t *anjay);
+
+	// managed by the scheduler
+	avs_time_monotonic_t deadline;
+};
+
+/**
+ * Adds a task to the scheduler. The task is first run on the next wakeup and
+ * then every @p task->period. The task structure must outlive the scheduler.
+ */
+int update_scheduler_add(struct update_task *task);
+
+/**
+ * Moves the deadline of @p task and re-arms the scheduler if it became the
+ * earliest one. Passing AVS_TIME_MONOTONIC_INVALID suspends the task.
+ */
+void update_scheduler_set_deadline(struct update_task *task, avs_time_monotonic_t deadline);
+
+/**
+ * Whether notifications of non-urgent changes are currently held back, which
+ * is the case if CONFIG_APP_QUEUE_BATCHING is enabled and the scheduler is
+ * running. Held changes are flushed every CONFIG_APP_QUEUE_BATCHING_PERIOD_S,
+ * together with a Registration Update, so that they share a single radio
+ * session in queue mode.
+ */
+bool update_scheduler_holding(void);
+
+/**
+ * Calls anjay_notify_changed() immediately if @p urgent is set or
+ * notifications are not held, or on the next flush otherwise.
+ */
+void update_scheduler_notify_changed(anjay_t *anjay, anjay_oid_t oid, anjay_iid_t iid,
+				     anjay_rid_t rid, bool urgent);
+
+/**
+ * Flushes the held notifications on the next wakeup, e.g. because an urgent
+ * notification opens a radio session anyway.
+ */
+void update_scheduler_flush_soon(void);
+
+void update_scheduler_start(anjay_t *anjay);
+void update_scheduler_stop(void);
+
+uint32_t update_scheduler_wakeup_count(void);
@@ -0,0 +1,23 @@
+# Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Settings shared by the test suites, included before find_package(Zephyr)
+
+set(demo_dir ${CMAKE_CURRENT_LIST_DIR}/../..)
+set(tests_common_dir ${CMAKE_CURRENT_LIST_DIR})
+# the options of the demo, e.g. the update periods, apply to the tests too
+set(KCONFIG_ROOT ${demo_dir}/Kconfig)
+list(APPEND EXTRA_CONF_FILE ${tests_common_dir}/common.conf)
+# and so do the emulated devices of its native_sim overlay
+list(APPEND EXTRA_DTC_OVERLAY_FILE ${demo_dir}/boards/native_sim.overlay)
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_anjay.h"
+
+anjay_t *test_anjay;
+
+void *test_anjay_setup(void)
+{
+	const anjay_configuration_t config = { .endpoint_name = "demo-test",
+					       .in_buffer_size = 1024,
+					       .out_buffer_size = 1024 };
+
+	test_anjay = anjay_new(&config);
+	zassert_not_null(test_anjay);
+	return NULL;
+}
+
+void test_anjay_teardown(void *fixture)
+{
+	(void)fixture;
+	anjay_delete(test_anjay);
+	test_anjay = NULL;
+}
+
+void test_anjay_run_for(int64_t duration_ms, int max_wait_ms)
+{
+	int64_t end_ms = k_uptime_get() + duration_ms;
+	int64_t now_ms;
+
+	while ((now_ms = k_uptime_get()) < end_ms) {
+		int64_t limit_ms = end_ms - now_ms;
+
+		if (max_wait_ms >= 0) {
+			limit_ms = MIN(limit_ms, max_wait_ms);
+		}
+
+		int wait_ms = anjay_sched_calculate_wait_time_ms(test_anjay, (int)limit_ms);
+
+		k_sleep(K_MSEC(wait_ms));
+		anjay_sched_run(test_anjay);
+	}
+}
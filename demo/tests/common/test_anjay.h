@@ -0,0 +1,41 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <anjay/anjay.h>
+
+/**
+ * Anjay instance of the test suites, used without any LwM2M server. Created by
+ * test_anjay_setup() and deleted by test_anjay_teardown(), which are meant to
+ * be the setup and teardown functions of the suite.
+ */
+extern anjay_t *test_anjay;
+
+void *test_anjay_setup(void);
+void test_anjay_teardown(void *fixture);
+
+/**
+ * Runs the Anjay scheduler for @p duration_ms of simulated time, sleeping in
+ * between like anjay_event_loop_run() does.
+ *
+ * @param max_wait_ms Longest sleep between the runs, e.g. to emulate the
+ *                    anjay_zephyr event loop, which is not woken up by other
+ *                    threads; -1 for no limit.
+ */
+void test_anjay_run_for(int64_t duration_ms, int max_wait_ms);
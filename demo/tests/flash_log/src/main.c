@@ -0,0 +1,174 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "flash_log.h"
+
+#define READ_MAX 8
+
+static struct sample_record make_record(uint32_t index)
+{
+	return (struct sample_record){
+		.timestamp = avs_time_real_from_scalar(1700000000 + index, AVS_TIME_S),
+		.value = index,
+		.oid = 3303,
+		.iid = 0,
+		.rid = 5700
+	};
+}
+
+static void append_records(uint32_t first_index, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		struct sample_record record = make_record(first_index + i);
+
+		zassert_ok(flash_log_append(&record));
+	}
+}
+
+static void assert_records(const struct sample_record *records, size_t count,
+			   uint32_t first_index)
+{
+	for (size_t i = 0; i < count; i++) {
+		struct sample_record expected = make_record(first_index + i);
+
+		zassert_equal(records[i].value, expected.value, "record %zu", i);
+		zassert_true(avs_time_real_equal(records[i].timestamp, expected.timestamp),
+			     "record %zu", i);
+		zassert_equal(records[i].oid, expected.oid);
+		zassert_equal(records[i].rid, expected.rid);
+	}
+}
+
+static void before(void *fixture)
+{
+	(void)fixture;
+
+	const struct flash_area *area;
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(sample_log_partition), &area));
+	zassert_ok(flash_area_erase(area, 0, area->fa_size));
+	flash_area_close(area);
+
+	zassert_ok(flash_log_init());
+	zassert_equal(flash_log_count(), 0);
+}
+
+ZTEST(flash_log, test_append_read_consume)
+{
+	struct sample_record records[READ_MAX];
+	uint32_t position;
+	size_t span;
+
+	append_records(0, 10);
+	zassert_equal(flash_log_count(), 10);
+
+	// reading does not consume
+	zassert_equal(flash_log_read(records, 4, &position, &span), 4);
+	zassert_equal(span, 4);
+	assert_records(records, 4, 0);
+	zassert_equal(flash_log_read(records, 4, &position, &span), 4);
+	assert_records(records, 4, 0);
+
+	flash_log_consume(position, span);
+	zassert_equal(flash_log_count(), 6);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), 6);
+	assert_records(records, 6, 4);
+
+	flash_log_consume(position, span);
+	zassert_equal(flash_log_count(), 0);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), 0);
+}
+
+ZTEST(flash_log, test_consumed_records_not_read_after_reboot)
+{
+	struct sample_record records[READ_MAX];
+	uint32_t position;
+	size_t span;
+
+	append_records(0, 10);
+	zassert_equal(flash_log_read(records, 4, &position, &span), 4);
+	flash_log_consume(position, span);
+
+	// the index is rebuilt from flash, like after a reboot
+	zassert_ok(flash_log_init());
+	zassert_equal(flash_log_count(), 6);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), 6);
+	assert_records(records, 6, 4);
+
+	// records appended after the reboot follow the remaining ones
+	append_records(10, 2);
+	zassert_equal(flash_log_count(), 8);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), 8);
+	assert_records(records, 8, 4);
+}
+
+ZTEST(flash_log, test_records_survive_reboot)
+{
+	struct sample_record records[READ_MAX];
+	uint32_t position;
+	size_t span;
+
+	append_records(0, 5);
+	zassert_ok(flash_log_init());
+	zassert_equal(flash_log_count(), 5);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), 5);
+	assert_records(records, 5, 0);
+}
+
+ZTEST(flash_log, test_wrap_while_read_in_flight)
+{
+	struct sample_record records[READ_MAX];
+	uint32_t position;
+	size_t span;
+	uint32_t appended = 10;
+	// counted since boot, i.e. across the tests
+	uint32_t dropped_before = flash_log_dropped_count();
+
+	append_records(0, appended);
+	zassert_equal(flash_log_read(records, 5, &position, &span), 5);
+
+	// the upload of the records read is in flight while the log wraps around
+	// and drops the oldest block, including those records
+	while (flash_log_dropped_count() == dropped_before) {
+		append_records(appended++, 1);
+	}
+
+	size_t count = flash_log_count();
+	uint32_t dropped = flash_log_dropped_count() - dropped_before;
+
+	TC_PRINT("Log full after %u records, %u dropped\n", appended, dropped);
+	zassert_equal(count, appended - dropped);
+
+	// the records read have been dropped, nothing that was not read is consumed
+	flash_log_consume(position, span);
+	zassert_equal(flash_log_count(), count);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), READ_MAX);
+	assert_records(records, READ_MAX, dropped);
+
+	flash_log_consume(position, span);
+	zassert_equal(flash_log_count(), count - READ_MAX);
+
+	// the position survives a reboot after the wrap as well
+	zassert_ok(flash_log_init());
+	zassert_equal(flash_log_count(), count - READ_MAX);
+	zassert_equal(flash_log_read(records, READ_MAX, &position, &span), READ_MAX);
+	assert_records(records, READ_MAX, dropped + READ_MAX);
+}
+
+ZTEST_SUITE(flash_log, NULL, NULL, before, NULL, NULL);
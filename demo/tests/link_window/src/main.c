@@ -0,0 +1,160 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <anjay/anjay.h>
+
+#include "link_window.h"
+#include "sensors.h"
+#include "test_anjay.h"
+#include "update_scheduler.h"
+
+#define TAU_MS (CONFIG_APP_LINK_WINDOW_FAKE_TAU_S * INT64_C(1000))
+#define ACTIVE_TIME_MS (CONFIG_APP_LINK_WINDOW_FAKE_ACTIVE_TIME_S * INT64_C(1000))
+#define MAX_DEFER_MS (CONFIG_APP_LINK_WINDOW_MAX_DEFER_S * INT64_C(1000))
+#define LEAD_MS CONFIG_APP_LINK_WINDOW_LEAD_MS
+
+// shorter than the TAU, so that unaligned sampling would wake the radio
+#define SENSORS_PERIOD_MS (30 * INT64_C(1000))
+// like the anjay_zephyr event loop, which is not woken up by other threads
+#define EVENT_LOOP_MAX_WAIT_MS 100
+#define CYCLES 10
+
+#define RUNS_MAX 64
+
+static int64_t start_ms;
+
+static int64_t sensors_runs_ms[RUNS_MAX];
+static size_t sensors_runs_count;
+static int64_t expedites_ms[RUNS_MAX];
+static int64_t expedite_horizons_ms[RUNS_MAX];
+static size_t expedites_count;
+
+static int64_t monotonic_to_elapsed_ms(avs_time_monotonic_t time)
+{
+	int64_t diff_ms;
+
+	avs_time_duration_to_scalar(&diff_ms, AVS_TIME_MS,
+				    avs_time_monotonic_diff(time, avs_time_monotonic_now()));
+	return k_uptime_get() + diff_ms - start_ms;
+}
+
+// the sensors module of the demo is replaced by the update task below
+void sensors_expedite(avs_time_monotonic_t horizon)
+{
+	zassert_true(expedites_count < RUNS_MAX);
+	expedites_ms[expedites_count] = k_uptime_get() - start_ms;
+	expedite_horizons_ms[expedites_count++] = monotonic_to_elapsed_ms(horizon);
+}
+
+static struct update_task sensors_task;
+
+// like update_sensor_objects() in main_app.c
+static void update_sensors(anjay_t *anjay)
+{
+	(void)anjay;
+	zassert_true(sensors_runs_count < RUNS_MAX);
+	sensors_runs_ms[sensors_runs_count++] = k_uptime_get() - start_ms;
+
+	avs_time_monotonic_t deadline = avs_time_monotonic_add(
+		avs_time_monotonic_now(),
+		avs_time_duration_from_scalar(SENSORS_PERIOD_MS, AVS_TIME_MS));
+
+	update_scheduler_set_deadline(&sensors_task, link_window_align(deadline));
+}
+
+static struct update_task sensors_task = { .name = "sensors", .run = update_sensors };
+
+ZTEST(link_window, test_align_while_asleep)
+{
+	avs_time_monotonic_t now = avs_time_monotonic_now();
+	avs_time_monotonic_t deadline =
+		avs_time_monotonic_add(now, avs_time_duration_from_scalar(1, AVS_TIME_S));
+
+	start_ms = k_uptime_get();
+	link_window_woken_up();
+	zassert_true(avs_time_monotonic_equal(link_window_align(deadline), deadline));
+
+	// deferred until shortly before the wakeup
+	link_window_sleep_entered(60 * 1000);
+	zassert_within(monotonic_to_elapsed_ms(link_window_align(deadline)), 60 * 1000 - LEAD_MS,
+		       1);
+
+	// but not by more than the maximum deferral
+	link_window_sleep_entered(MAX_DEFER_MS + 3600 * 1000);
+	zassert_within(monotonic_to_elapsed_ms(link_window_align(deadline)),
+		       1000 + MAX_DEFER_MS, 1);
+
+	// nor moved earlier
+	link_window_sleep_entered(LEAD_MS / 2);
+	zassert_true(avs_time_monotonic_equal(link_window_align(deadline), deadline));
+
+	link_window_woken_up();
+}
+
+ZTEST(link_window, test_sampling_follows_fake_modem)
+{
+	struct link_window_status before;
+	struct link_window_status after;
+
+	link_window_get_status(&before);
+	start_ms = k_uptime_get();
+	sensors_task.period = AVS_TIME_DURATION_INVALID;
+	zassert_ok(update_scheduler_add(&sensors_task));
+	link_window_start(test_anjay, &sensors_task);
+	update_scheduler_start(test_anjay);
+
+	// ends right before the last wakeup
+	test_anjay_run_for(CYCLES * TAU_MS - LEAD_MS / 2, EVENT_LOOP_MAX_WAIT_MS);
+	link_window_stop();
+	update_scheduler_stop();
+	link_window_get_status(&after);
+
+	TC_PRINT("Sensor runs in %d TAU cycles: %zu, %lld unaligned\n", CYCLES,
+		 sensors_runs_count, CYCLES * TAU_MS / SENSORS_PERIOD_MS);
+
+	zassert_equal(after.planned_wakeups - before.planned_wakeups, CYCLES);
+	zassert_equal(after.unplanned_wakeups, before.unplanned_wakeups);
+	zassert_equal(expedites_count, CYCLES);
+
+	for (size_t i = 0; i < expedites_count; i++) {
+		int64_t wakeup_ms = (int64_t)(i + 1) * TAU_MS;
+
+		// sampled right before the wakeup, for the whole active time
+		zassert_between_inclusive(expedites_ms[i], wakeup_ms - LEAD_MS,
+					  wakeup_ms - LEAD_MS + EVENT_LOOP_MAX_WAIT_MS,
+					  "expedited at %lld ms", (long long)expedites_ms[i]);
+		zassert_within(expedite_horizons_ms[i], wakeup_ms + ACTIVE_TIME_MS,
+			       EVENT_LOOP_MAX_WAIT_MS);
+	}
+
+	// apart from the first active time, the sensors are sampled only right
+	// before the wakeups
+	for (size_t i = 0; i < sensors_runs_count; i++) {
+		int64_t run_ms = sensors_runs_ms[i];
+		int64_t to_wakeup_ms = TAU_MS - run_ms % TAU_MS;
+
+		if (run_ms < ACTIVE_TIME_MS + SENSORS_PERIOD_MS) {
+			continue;
+		}
+		zassert_true(to_wakeup_ms <= LEAD_MS, "sampled at %lld ms", (long long)run_ms);
+	}
+	zassert_true(sensors_runs_count <= CYCLES + 2, "%zu runs", sensors_runs_count);
+}
+
+ZTEST_SUITE(link_window, NULL, test_anjay_setup, NULL, NULL, test_anjay_teardown);
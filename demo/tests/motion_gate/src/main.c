@@ -0,0 +1,219 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/emul_sensor.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/version.h>
+#include <zephyr/ztest.h>
+
+#include <anjay/anjay.h>
+
+#include "motion_gate.h"
+#include "sensors.h"
+#include "sensors_config.h"
+#include "test_anjay.h"
+#include "update_scheduler.h"
+
+BUILD_ASSERT(MOTION_GATE_AVAILABLE, "the accelerometer of the native_sim overlay is expected");
+
+#define GRAVITY_MS2 9.80665
+
+/**
+ * Accelerometer trace of a tracked asset: a short drive, a long stop and
+ * another drive. While driving, consecutive samples differ by 4 m/s^2; while
+ * parked, only by the 4 mg of sensor noise, well below the motion threshold.
+ */
+static const struct {
+	int64_t duration_ms;
+	double amplitude_ms2;
+} trace[] = {
+	{ 60 * 1000, 2.0 },
+	{ 30 * 60 * 1000, 0.02 },
+	{ 2 * 60 * 1000, 2.0 },
+};
+
+#define DRIVE_END_MS (trace[0].duration_ms)
+#define STOP_END_MS (DRIVE_END_MS + trace[1].duration_ms)
+#define TRACE_END_MS (STOP_END_MS + trace[2].duration_ms)
+
+// fits the sum of the gravity and the driving amplitude
+#define Q31_SHIFT 5
+#define READY_TIMEOUT_MS 1000
+
+#define RUNS_MAX 512
+
+static const struct emul *const accelerometer_emul = EMUL_DT_GET(ACCELEROMETER_NODE);
+static struct sensor_context *accelerometer;
+static int64_t trace_start_ms;
+
+static int64_t location_runs_ms[RUNS_MAX];
+static size_t location_runs_count;
+
+static int set_channel(enum sensor_channel channel, double value)
+{
+	q31_t q31_value = (q31_t)ldexp(value, 31 - Q31_SHIFT);
+
+#if KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+	return emul_sensor_backend_set_channel(
+		accelerometer_emul, (struct sensor_chan_spec){ channel, 0 }, &q31_value, Q31_SHIFT);
+#else  // KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+	return emul_sensor_backend_set_channel(accelerometer_emul, channel, &q31_value, Q31_SHIFT);
+#endif // KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(3, 6, 99)
+}
+
+// loads the sample of the trace into the emulator right before the driver reads it
+static int replay_trace(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+	(void)target;
+	(void)msgs;
+	(void)num_msgs;
+	(void)addr;
+
+	int64_t elapsed_ms = k_uptime_get() - trace_start_ms;
+	size_t segment = 0;
+
+	while (segment < ARRAY_SIZE(trace) - 1 && elapsed_ms >= trace[segment].duration_ms) {
+		elapsed_ms -= trace[segment++].duration_ms;
+	}
+
+	// the sign alternates every second, i.e. between consecutive polls
+	double offset = trace[segment].amplitude_ms2;
+
+	// also called on the work queue of the sensors module, where assertions do not work
+	if (set_channel(SENSOR_CHAN_ACCEL_X, (elapsed_ms / 1000) % 2 ? offset : -offset) ||
+	    set_channel(SENSOR_CHAN_ACCEL_Y, 0.0) || set_channel(SENSOR_CHAN_ACCEL_Z, GRAVITY_MS2)) {
+		return -EIO;
+	}
+	return -ENOSYS;
+}
+
+static struct i2c_emul_api trace_api = {
+	.transfer = replay_trace,
+};
+
+static void update_location(anjay_t *anjay)
+{
+	(void)anjay;
+	zassert_true(location_runs_count < RUNS_MAX);
+	location_runs_ms[location_runs_count++] = k_uptime_get() - trace_start_ms;
+	motion_gate_task_done();
+}
+
+static struct update_task location_task = { .name = "location", .run = update_location };
+
+static size_t runs_between(int64_t from_ms, int64_t to_ms)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < location_runs_count; i++) {
+		count += location_runs_ms[i] >= from_ms && location_runs_ms[i] < to_ms;
+	}
+	return count;
+}
+
+static int64_t first_run_since(int64_t from_ms)
+{
+	for (size_t i = 0; i < location_runs_count; i++) {
+		if (location_runs_ms[i] >= from_ms) {
+			return location_runs_ms[i];
+		}
+	}
+	return -1;
+}
+
+static struct sensor_context *find_accelerometer(void)
+{
+	for (size_t i = 0; i < sensors_installed_count(); i++) {
+		struct sensor_context *sensor = sensors_installed_get(i);
+
+		if (sensor->device == DEVICE_DT_GET(ACCELEROMETER_NODE) &&
+		    sensor->channel == SENSOR_CHAN_ACCEL_XYZ) {
+			return sensor;
+		}
+	}
+	return NULL;
+}
+
+static void *setup(void)
+{
+	test_anjay_setup();
+	accelerometer_emul->bus.i2c->mock_api = &trace_api;
+	// like main_app.c, the gate reads the accelerometer through the sensors module
+	sensors_install(test_anjay);
+	sensors_init_start();
+
+	accelerometer = find_accelerometer();
+	zassert_not_null(accelerometer);
+
+	// the device is initialized on the work queue of the sensors module
+	double values[3];
+	int64_t ready_deadline_ms = k_uptime_get() + READY_TIMEOUT_MS;
+
+	while (sensors_read_latest(accelerometer, values)) {
+		zassert_true(k_uptime_get() < ready_deadline_ms, "accelerometer not ready");
+		k_sleep(K_MSEC(10));
+	}
+	zassert_within(values[2], GRAVITY_MS2, 0.1, "%f m/s^2", values[2]);
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	update_scheduler_stop();
+	sensors_release();
+	accelerometer_emul->bus.i2c->mock_api = NULL;
+	test_anjay_teardown(fixture);
+}
+
+ZTEST(motion_gate, test_trace_replay)
+{
+	const int64_t period_ms = CONFIG_APP_LOCATION_UPDATE_PERIOD_MS;
+	const int64_t max_period_ms = CONFIG_APP_MOTION_GATE_MAX_PERIOD_S * INT64_C(1000);
+
+	trace_start_ms = k_uptime_get();
+	motion_gate_start(&location_task, period_ms);
+	update_scheduler_start(test_anjay);
+	test_anjay_run_for(TRACE_END_MS, -1);
+
+	size_t driving_runs = runs_between(0, DRIVE_END_MS);
+	size_t parked_runs = runs_between(DRIVE_END_MS, STOP_END_MS);
+	int64_t resume_latency_ms = first_run_since(STOP_END_MS) - STOP_END_MS;
+
+	TC_PRINT("Location updates while parked for %lld s: %zu, %lld without the gate\n",
+		 (long long)(trace[1].duration_ms / 1000), parked_runs,
+		 (long long)(trace[1].duration_ms / period_ms));
+	TC_PRINT("Location update %lld ms after the motion resumed\n",
+		 (long long)resume_latency_ms);
+
+	// updates keep their period while driving
+	zassert_within(driving_runs, DRIVE_END_MS / period_ms, 1, "%zu runs", driving_runs);
+	// the period doubles up to the maximum while parked, i.e. for 5 s and
+	// 60 s: 10, 20, 40, 60, 60...
+	zassert_true(parked_runs <= trace[1].duration_ms / max_period_ms + 6, "%zu runs",
+		     parked_runs);
+	zassert_true(parked_runs < trace[1].duration_ms / period_ms / 4, "%zu runs", parked_runs);
+	// motion is noticed on the next poll of the accelerometer
+	zassert_between_inclusive(resume_latency_ms, 0, CONFIG_APP_MOTION_GATE_POLL_PERIOD_MS,
+				  "%lld ms", (long long)resume_latency_ms);
+	zassert_within(runs_between(STOP_END_MS, TRACE_END_MS), trace[2].duration_ms / period_ms,
+		       2);
+}
+
+ZTEST_SUITE(motion_gate, NULL, setup, NULL, NULL, teardown);
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/ztest.h>
+
+#include "peripherals.h"
+#include "sensor_cache.h"
+
+BUILD_ASSERT(ACCELEROMETER_AVAILABLE && GYROMETER_AVAILABLE && MAGNETOMETER_AVAILABLE &&
+		     TEMPERATURE_AVAILABLE,
+	     "the sensors of the native_sim overlay of the demo are expected");
+
+// the channels read in an update cycle, as registered in sensors_config.c
+static const struct {
+	const struct device *device;
+	enum sensor_channel channel;
+} channels[] = {
+	{ DEVICE_DT_GET(ACCELEROMETER_NODE), SENSOR_CHAN_ACCEL_XYZ },
+	{ DEVICE_DT_GET(GYROMETER_NODE), SENSOR_CHAN_GYRO_XYZ },
+	{ DEVICE_DT_GET(MAGNETOMETER_NODE), SENSOR_CHAN_MAGN_XYZ },
+	{ DEVICE_DT_GET(TEMPERATURE_NODE), SENSOR_CHAN_AMBIENT_TEMP },
+};
+
+#define EMUL_GET(node_id) EMUL_DT_GET(node_id),
+
+// the emulated targets of the sensors, on the I2C bus of the overlay
+static const struct emul *const targets[] = { DT_FOREACH_CHILD_STATUS_OKAY(DT_NODELABEL(i2c0),
+									    EMUL_GET) };
+
+static atomic_t transfers_count;
+
+// counts the transfers that reach the emulated bus, then lets the target handle them
+static int count_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+			  int addr)
+{
+	(void)target;
+	(void)msgs;
+	(void)num_msgs;
+	(void)addr;
+
+	atomic_inc(&transfers_count);
+	return -ENOSYS;
+}
+
+static struct i2c_emul_api counting_api = {
+	.transfer = count_transfer,
+};
+
+static uint32_t transfers(void)
+{
+	return (uint32_t)atomic_get(&transfers_count);
+}
+
+// transfers of a single uncached fetch of @p device
+static uint32_t transfers_per_fetch(const struct device *device)
+{
+	uint32_t before = transfers();
+
+	zassert_ok(sensor_sample_fetch(device), "%s", device->name);
+	return transfers() - before;
+}
+
+static void read_channels(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		struct sensor_value values[3];
+
+		zassert_ok(sensor_cache_fetch(channels[i].device), "%s",
+			   channels[i].device->name);
+		zassert_ok(sensor_channel_get(channels[i].device, channels[i].channel, values),
+			   "%s", channels[i].device->name);
+	}
+}
+
+static void *setup(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		zassert_true(device_is_ready(channels[i].device), "%s",
+			     channels[i].device->name);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(targets); i++) {
+		targets[i]->bus.i2c->mock_api = &counting_api;
+	}
+	return NULL;
+}
+
+ZTEST(sensor_cache, test_transfers_per_cycle)
+{
+	const uint32_t cycles = 100;
+	uint32_t cached_per_cycle = 0;
+	uint32_t uncached_per_cycle = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		uint32_t per_fetch = transfers_per_fetch(channels[i].device);
+		size_t j = 0;
+
+		zassert_true(per_fetch > 0, "%s", channels[i].device->name);
+		while (j < i && channels[j].device != channels[i].device) {
+			j++;
+		}
+		// a device shared by several channels is fetched once per cycle
+		cached_per_cycle += j == i ? per_fetch : 0;
+		uncached_per_cycle += per_fetch;
+	}
+
+	uint32_t before = transfers();
+
+	for (uint32_t i = 0; i < cycles; i++) {
+		sensor_cache_new_cycle();
+		read_channels();
+	}
+
+	uint32_t cycle_transfers = (transfers() - before) / cycles;
+
+	TC_PRINT("I2C transfers per cycle: %u with the cache, %u without\n", cycle_transfers,
+		 uncached_per_cycle);
+	// the accelerometer and gyrometer of the BMI160 share a single fetch
+	zassert_equal_ptr(channels[0].device, channels[1].device);
+	zassert_equal(transfers() - before, cycles * cached_per_cycle);
+	zassert_true(cached_per_cycle < uncached_per_cycle);
+}
+
+ZTEST(sensor_cache, test_stale_sample_fetched_again)
+{
+	const struct device *device = channels[0].device;
+	uint32_t per_fetch = transfers_per_fetch(device);
+
+	sensor_cache_new_cycle();
+	zassert_ok(sensor_cache_fetch(device));
+
+	uint32_t before = transfers();
+
+	zassert_ok(sensor_cache_fetch(device));
+	zassert_equal(transfers(), before);
+
+	k_sleep(K_MSEC(CONFIG_APP_SENSOR_CACHE_MAX_AGE_MS + 1));
+	zassert_ok(sensor_cache_fetch(device));
+	zassert_equal(transfers(), before + per_fetch);
+}
+
+ZTEST_SUITE(sensor_cache, NULL, setup, NULL, NULL, NULL);
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "status_led.h"
+
+BUILD_ASSERT(STATUS_LED_AVAILABLE, "the status LED of the native_sim overlay is expected");
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(DT_PARENT(STATUS_LED_NODE), gpio_leds),
+	     "the status LED is expected to be driven by the timer");
+
+static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(STATUS_LED_NODE, gpios);
+
+// resolution of the sampling of the pin
+#define SAMPLE_PERIOD_MS 10
+
+struct pin_trace {
+	int64_t on_ms;
+	int rising_edges;
+};
+
+static int pin_get(void)
+{
+	return gpio_emul_output_get(led.port, led.pin);
+}
+
+static struct pin_trace trace_pin(int64_t duration_ms)
+{
+	struct pin_trace trace = { 0 };
+	int previous = pin_get();
+
+	for (int64_t elapsed_ms = 0; elapsed_ms < duration_ms; elapsed_ms += SAMPLE_PERIOD_MS) {
+		k_sleep(K_MSEC(SAMPLE_PERIOD_MS));
+
+		int value = pin_get();
+
+		trace.on_ms += value ? SAMPLE_PERIOD_MS : 0;
+		trace.rising_edges += value && !previous;
+		previous = value;
+	}
+	return trace;
+}
+
+// lets the system work queue apply the state
+static void settle(void)
+{
+	k_sleep(K_MSEC(1));
+}
+
+static void *setup(void)
+{
+	zassert_true(gpio_is_ready_dt(&led));
+	status_led_init();
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	(void)fixture;
+	status_led_low_power(false);
+	status_led_set_pattern(STATUS_LED_PATTERN_OFF);
+	settle();
+}
+
+ZTEST(status_led, test_constant_patterns)
+{
+	status_led_set_pattern(STATUS_LED_PATTERN_ON);
+	settle();
+	zassert_equal(pin_get(), 1);
+
+	status_led_set_pattern(STATUS_LED_PATTERN_OFF);
+	settle();
+	zassert_equal(pin_get(), 0);
+}
+
+ZTEST(status_led, test_heartbeat)
+{
+	status_led_set_pattern(STATUS_LED_PATTERN_HEARTBEAT);
+
+	struct pin_trace trace = trace_pin(5000);
+
+	// 100 ms on every second
+	zassert_within(trace.rising_edges, 5, 1);
+	zassert_within(trace.on_ms, 500, 2 * SAMPLE_PERIOD_MS * 5);
+}
+
+ZTEST(status_led, test_connecting)
+{
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
+
+	struct pin_trace trace = trace_pin(5000);
+
+	// 250 ms on, 250 ms off
+	zassert_within(trace.rising_edges, 10, 1);
+	zassert_within(trace.on_ms, 2500, 2 * SAMPLE_PERIOD_MS * 10);
+}
+
+ZTEST(status_led, test_error_code)
+{
+	// 3 blinks of 200 ms with 300 ms breaks, the last break being 1500 ms
+	const int64_t period_ms = 3 * 200 + 2 * 300 + 1500;
+
+	status_led_error(3);
+
+	struct pin_trace trace = trace_pin(2 * period_ms);
+
+	zassert_within(trace.rising_edges, 6, 1);
+	zassert_within(trace.on_ms, 6 * 200, 2 * SAMPLE_PERIOD_MS * 6);
+}
+
+ZTEST(status_led, test_low_power)
+{
+	gpio_flags_t flags;
+
+	status_led_set_pattern(STATUS_LED_PATTERN_CONNECTING);
+	status_led_low_power(true);
+	settle();
+
+	// the pin is disconnected and stays so, as the timer is stopped
+	zassert_ok(gpio_emul_flags_get(led.port, led.pin, &flags));
+	zassert_equal(flags & (GPIO_INPUT | GPIO_OUTPUT), 0);
+	zassert_equal(trace_pin(1000).rising_edges, 0);
+
+	// the pattern is restored on leaving the mode
+	status_led_low_power(false);
+	settle();
+	zassert_ok(gpio_emul_flags_get(led.port, led.pin, &flags));
+	zassert_true(flags & GPIO_OUTPUT);
+	zassert_within(trace_pin(1000).rising_edges, 2, 1);
+}
+
+ZTEST_SUITE(status_led, NULL, setup, before, NULL, NULL);
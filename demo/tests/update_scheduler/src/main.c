@@ -0,0 +1,218 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <anjay/anjay.h>
+
+#include "test_anjay.h"
+#include "update_scheduler.h"
+
+#define HOUR_MS (3600 * INT64_C(1000))
+// the object update loop of the demo used to wake up every second
+#define FIXED_POLL_WAKEUPS_PER_HOUR 3600
+// the defaults of the update periods in the Kconfig of the demo
+#define DEFAULT_PERIODS                                                                            \
+	(CONFIG_APP_BUZZER_UPDATE_PERIOD_MS == 1000 && CONFIG_APP_SWITCH_POLL_PERIOD_MS == 1000 && \
+	 CONFIG_APP_SENSORS_UPDATE_PERIOD_MS == 5000 &&                                            \
+	 CONFIG_APP_LOCATION_UPDATE_PERIOD_MS == 5000)
+
+static uint32_t buzzer_runs;
+static uint32_t switch_runs;
+static uint32_t sensors_runs;
+static uint32_t location_runs;
+static uint32_t oneshot_runs;
+
+static void run_buzzer(anjay_t *anjay)
+{
+	(void)anjay;
+	buzzer_runs++;
+}
+
+static void run_switch(anjay_t *anjay)
+{
+	(void)anjay;
+	switch_runs++;
+}
+
+static void run_sensors(anjay_t *anjay)
+{
+	(void)anjay;
+	sensors_runs++;
+}
+
+static void run_location(anjay_t *anjay)
+{
+	(void)anjay;
+	location_runs++;
+}
+
+static void run_oneshot(anjay_t *anjay)
+{
+	(void)anjay;
+	oneshot_runs++;
+}
+
+static struct update_task buzzer_task = { .name = "buzzer", .run = run_buzzer };
+static struct update_task switch_task = { .name = "switch", .run = run_switch };
+static struct update_task sensors_task = { .name = "sensors", .run = run_sensors };
+static struct update_task location_task = { .name = "location", .run = run_location };
+static struct update_task oneshot_task = { .name = "oneshot", .run = run_oneshot };
+
+/**
+ * Periodic tasks of main_app.c on a board with a buzzer and switches that
+ * cannot raise interrupts, i.e. the most that the demo polls. The sensors are
+ * sampled every CONFIG_APP_SENSORS_UPDATE_PERIOD_MS, as with
+ * CONFIG_APP_SAMPLE_BUFFER, instead of on the deadlines of their observations.
+ */
+static const struct {
+	struct update_task *task;
+	int32_t period_ms;
+} demo_tasks[] = {
+	{ &buzzer_task, CONFIG_APP_BUZZER_UPDATE_PERIOD_MS },
+	{ &switch_task, CONFIG_APP_SWITCH_POLL_PERIOD_MS },
+	{ &sensors_task, CONFIG_APP_SENSORS_UPDATE_PERIOD_MS },
+	{ &location_task, CONFIG_APP_LOCATION_UPDATE_PERIOD_MS },
+};
+
+static int64_t gcd(int64_t a, int64_t b)
+{
+	while (b) {
+		int64_t rest = a % b;
+
+		a = b;
+		b = rest;
+	}
+	return a;
+}
+
+// instants in [0, @p duration_ms] at which at least one of the demo tasks is due
+static uint32_t demo_deadlines(int64_t duration_ms)
+{
+	int64_t step_ms = demo_tasks[0].period_ms;
+	uint32_t deadlines = 0;
+
+	for (size_t i = 1; i < ARRAY_SIZE(demo_tasks); i++) {
+		step_ms = gcd(step_ms, demo_tasks[i].period_ms);
+	}
+
+	for (int64_t time_ms = 0; time_ms <= duration_ms; time_ms += step_ms) {
+		for (size_t i = 0; i < ARRAY_SIZE(demo_tasks); i++) {
+			if (time_ms % demo_tasks[i].period_ms == 0) {
+				deadlines++;
+				break;
+			}
+		}
+	}
+	return deadlines;
+}
+
+static void add_task(struct update_task *task, int32_t period_ms)
+{
+	task->period = period_ms > 0 ? avs_time_duration_from_scalar(period_ms, AVS_TIME_MS)
+				     : AVS_TIME_DURATION_INVALID;
+	zassert_ok(update_scheduler_add(task));
+}
+
+/**
+ * Runs the Anjay scheduler for @p duration_ms of simulated time.
+ *
+ * @returns Number of wakeups of the update scheduler in that time.
+ */
+static uint32_t run_for(int64_t duration_ms)
+{
+	uint32_t wakeups_before = update_scheduler_wakeup_count();
+
+	test_anjay_run_for(duration_ms, -1);
+	return update_scheduler_wakeup_count() - wakeups_before;
+}
+
+static void before(void *fixture)
+{
+	(void)fixture;
+	buzzer_runs = 0;
+	switch_runs = 0;
+	sensors_runs = 0;
+	location_runs = 0;
+	oneshot_runs = 0;
+}
+
+static void after(void *fixture)
+{
+	(void)fixture;
+	update_scheduler_stop();
+}
+
+ZTEST(update_scheduler, test_wakeups_per_hour)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(demo_tasks); i++) {
+		add_task(demo_tasks[i].task, demo_tasks[i].period_ms);
+	}
+	update_scheduler_start(test_anjay);
+
+	uint32_t wakeups = run_for(HOUR_MS);
+	uint32_t runs = buzzer_runs + switch_runs + sensors_runs + location_runs;
+
+	TC_PRINT("Wakeups per simulated hour: %u for %u task runs, fixed 1 s poll: %d\n", wakeups,
+		 runs, FIXED_POLL_WAKEUPS_PER_HOUR);
+
+	// the last run may fall just outside of the hour
+	zassert_within(buzzer_runs, HOUR_MS / CONFIG_APP_BUZZER_UPDATE_PERIOD_MS + 1, 1);
+	zassert_within(switch_runs, HOUR_MS / CONFIG_APP_SWITCH_POLL_PERIOD_MS + 1, 1);
+	zassert_within(sensors_runs, HOUR_MS / CONFIG_APP_SENSORS_UPDATE_PERIOD_MS + 1, 1);
+	zassert_within(location_runs, HOUR_MS / CONFIG_APP_LOCATION_UPDATE_PERIOD_MS + 1, 1);
+	// tasks whose deadlines coincide share a wakeup
+	zassert_within(wakeups, demo_deadlines(HOUR_MS), 1, "%u wakeups", wakeups);
+	if (DEFAULT_PERIODS) {
+		// the buzzer and the switches wake the loop up as often as the
+		// fixed poll did, and the other tasks share their wakeups
+		zassert_within(wakeups, FIXED_POLL_WAKEUPS_PER_HOUR + 1, 1, "%u wakeups", wakeups);
+	}
+}
+
+ZTEST(update_scheduler, test_coinciding_deadlines_share_wakeup)
+{
+	add_task(&sensors_task, 2000);
+	add_task(&location_task, 4000);
+	update_scheduler_start(test_anjay);
+
+	uint32_t wakeups = run_for(60 * 1000);
+
+	// every other run of the sensors coincides with a run of the location
+	zassert_within(sensors_runs, 30, 1);
+	zassert_within(location_runs, 15, 1);
+	zassert_equal(wakeups, sensors_runs, "%u wakeups, %u runs", wakeups, sensors_runs);
+}
+
+ZTEST(update_scheduler, test_idle_without_deadlines)
+{
+	add_task(&oneshot_task, 0);
+	update_scheduler_start(test_anjay);
+
+	// a task without a period is run once, right after being added
+	zassert_equal(run_for(HOUR_MS), 1);
+	zassert_equal(oneshot_runs, 1);
+
+	update_scheduler_set_deadline(&oneshot_task,
+				      avs_time_monotonic_add(avs_time_monotonic_now(),
+							     avs_time_duration_from_scalar(
+								     10, AVS_TIME_S)));
+	zassert_equal(run_for(HOUR_MS), 1);
+	zassert_equal(oneshot_runs, 2);
+}
+
+ZTEST_SUITE(update_scheduler, NULL, test_anjay_setup, before, after, test_anjay_teardown);
@@ -26,6 +26,7 @@
  */
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <anjay/anjay.h>
 #include <avsystem/commons/avs_defs.h>
@@ -106,6 +107,11 @@ static const struct pattern_detector_instance_state initial_state;
 static struct pattern_detector_object *installed_obj;
 static bool wrapper_initialized;
 
+#ifdef CONFIG_APP_STATIC_OBJECTS
+static struct pattern_detector_object object_storage;
+static struct pattern_detector_instance instances_storage[CONFIG_APP_PATTERN_DETECTOR_MAX_LABELS];
+#endif // CONFIG_APP_STATIC_OBJECTS
+
 static void schedule_next_measure(struct pattern_detector_object *obj)
 {
 	const int64_t next_run_timestamp =
@@ -251,6 +257,47 @@ static struct pattern_detector_instance *add_instance(struct pattern_detector_ob
 	return init_instance(created, iid) ? NULL : created;
 }
 
+static struct pattern_detector_object *alloc_object(void)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	if (ei_wrapper_get_classifier_label_count() > AVS_ARRAY_SIZE(instances_storage)) {
+		LOG_ERR("Too many classifier labels, increase "
+			"CONFIG_APP_PATTERN_DETECTOR_MAX_LABELS");
+		return NULL;
+	}
+
+	memset(&object_storage, 0, sizeof(object_storage));
+	memset(instances_storage, 0, sizeof(instances_storage));
+	object_storage.instances = instances_storage;
+	return &object_storage;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	struct pattern_detector_object *obj = (struct pattern_detector_object *)avs_calloc(
+		1, sizeof(struct pattern_detector_object));
+	if (!obj) {
+		return NULL;
+	}
+
+	obj->instances = (struct pattern_detector_instance *)avs_calloc(
+		ei_wrapper_get_classifier_label_count(), sizeof(struct pattern_detector_instance));
+	if (!obj->instances) {
+		avs_free(obj);
+		return NULL;
+	}
+
+	return obj;
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
+
+static void free_object(struct pattern_detector_object *obj)
+{
+#ifdef CONFIG_APP_STATIC_OBJECTS
+	(void)obj;
+#else  // CONFIG_APP_STATIC_OBJECTS
+	avs_free(obj->instances);
+	avs_free(obj);
+#endif // CONFIG_APP_STATIC_OBJECTS
+}
+
 static int list_resources(anjay_t *anjay, const anjay_dm_object_def_t *const *obj_ptr,
 			  anjay_iid_t iid, anjay_dm_resource_list_ctx_t *ctx)
 {
@@ -338,25 +385,17 @@ const anjay_dm_object_def_t **pattern_detector_object_create(void)
 	}
 	LOG_INF("Edge Impulse prediction scheduled...");
 
-	struct pattern_detector_object *obj = (struct pattern_detector_object *)avs_calloc(
-		1, sizeof(struct pattern_detector_object));
+	struct pattern_detector_object *obj = alloc_object();
+
 	if (!obj) {
 		return NULL;
 	}
 	obj->def = &obj_def;
 	obj->dev = dev;
 
-	obj->instances = (struct pattern_detector_instance *)avs_calloc(
-		ei_wrapper_get_classifier_label_count(), sizeof(struct pattern_detector_instance));
-	if (!obj->instances) {
-		avs_free(obj);
-		return NULL;
-	}
-
 	for (size_t i = 0; i < ei_wrapper_get_classifier_label_count(); i++) {
 		if (!add_instance(obj, i)) {
-			avs_free(obj->instances);
-			avs_free(obj);
+			free_object(obj);
 			return NULL;
 		}
 	}
@@ -414,7 +453,6 @@ void pattern_detector_object_release(const anjay_dm_object_def_t **def)
 
 		installed_obj = NULL;
 
-		avs_free(obj->instances);
-		avs_free(obj);
+		free_object(obj);
 	}
 }
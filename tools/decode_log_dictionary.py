@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""
+Decodes the output of a sample built with overlay_log_dictionary.conf, i.e.
+with Zephyr dictionary logging in the hexadecimal UART format, using the
+dictionary parser shipped with Zephyr and the log_dictionary.json database
+generated by the same build.
+
+The UART output may be captured to a file, e.g. with
+"cat /dev/ttyACM0 > capture.txt", or piped to the standard input. Lines that
+are not made of hexadecimal digits only, such as the messages printed by
+"west build -t run" before the emulator starts, are skipped, as are line breaks
+inserted by the terminal.
+"""
+import argparse
+import logging
+import os
+import string
+import sys
+
+HEX_DIGITS = set(string.hexdigits.encode())
+
+
+def _import_dictionary_parser(zephyr_base):
+    if not zephyr_base:
+        raise RuntimeError('ZEPHYR_BASE is not set, pass --zephyr-base')
+    sys.path.insert(0, os.path.join(zephyr_base, 'scripts', 'logging', 'dictionary'))
+    try:
+        import dictionary_parser
+        from dictionary_parser.log_database import LogDatabase
+    except ImportError as e:
+        raise RuntimeError('Dictionary parser not found in %s: %s' % (zephyr_base, e))
+    return dictionary_parser, LogDatabase
+
+
+def _read_hex(stream):
+    hex_data = b''.join(line.strip() for line in stream
+                        if all(byte in HEX_DIGITS for byte in line.strip()))
+    if len(hex_data) % 2:
+        # the capture ends in the middle of a byte
+        hex_data = hex_data[:-1]
+    return bytes.fromhex(hex_data.decode())
+
+
+def _main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('database', help='build/zephyr/log_dictionary.json of the build')
+    parser.add_argument('input', nargs='?', help='captured UART output (default: stdin)')
+    parser.add_argument('--zephyr-base', default=os.environ.get('ZEPHYR_BASE'),
+                        help='Zephyr tree of the build (default: $ZEPHYR_BASE)')
+    parser.add_argument('--debug', action='store_true', help='print the raw messages as well')
+    args = parser.parse_args()
+
+    # the dictionary parser prints the decoded messages through the root logger
+    logging.basicConfig(format='%(message)s',
+                        level=logging.DEBUG if args.debug else logging.INFO)
+
+    try:
+        dictionary_parser, LogDatabase = _import_dictionary_parser(args.zephyr_base)
+    except RuntimeError as e:
+        sys.exit(str(e))
+
+    database = LogDatabase.read_json_database(args.database)
+    if database is None:
+        sys.exit('Could not read the database %s' % (args.database,))
+
+    log_parser = dictionary_parser.get_parser(database)
+    if log_parser is None:
+        sys.exit('Unsupported dictionary database version')
+
+    if args.input:
+        with open(args.input, 'rb') as f:
+            log_data = _read_hex(f)
+    else:
+        log_data = _read_hex(sys.stdin.buffer)
+
+    if not log_parser.parse_log_data(log_data, debug=args.debug):
+        sys.exit('Could not decode all of the log data, is the database of the same build?')
+
+
+if __name__ == '__main__':
+    _main()
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
+
+LOG_MODULE_REGISTER(log_benchmark);
+
+#define LOG_CALLS 32
+#define ROUNDS 16
+// time for the logging thread to output a round of deferred messages
+#define ROUND_INTERVAL_MS 500
+
+/**
+ * Logs LOG_CALLS messages with the same arguments as a typical log call of the
+ * client and returns the number of cycles it took.
+ */
+static uint32_t log_calls(void)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < LOG_CALLS; i++) {
+		LOG_INF("Log call %d of %d: %s", i + 1, LOG_CALLS, "benchmark");
+	}
+	return k_cycle_get_32() - start;
+}
+
+/**
+ * Runs ROUNDS rounds of log_calls(), waiting interval_ms after each of them,
+ * and reports the mean and minimum cost of a single log call.
+ */
+static void measure(const char *mode, int32_t interval_ms)
+{
+	uint32_t min_cycles = UINT32_MAX;
+	uint64_t total_cycles = 0;
+
+	for (int i = 0; i < ROUNDS; i++) {
+		uint32_t cycles = log_calls();
+
+		min_cycles = MIN(min_cycles, cycles);
+		total_cycles += cycles;
+		k_msleep(interval_ms);
+	}
+
+	uint32_t mean_cycles = (uint32_t)(total_cycles / ROUNDS / LOG_CALLS);
+
+	LOG_INF("Log call (%s): mean %u cycles (%llu ns), min %u cycles", mode, mean_cycles,
+		k_cyc_to_ns_floor64(mean_cycles), min_cycles / LOG_CALLS);
+}
+
+int main(void)
+{
+	// the messages are only stored in the buffer, the logging thread formats
+	// and outputs them while waiting for the next round
+	measure("deferred", ROUND_INTERVAL_MS);
+
+	// flushes the messages above, the following ones are output synchronously,
+	// so the cost includes formatting and the output by the backend
+	LOG_PANIC();
+	measure("synchronous", 0);
+	LOG_INF("Log benchmark finished, %u cycles per second", sys_clock_hw_cycles_per_sec());
+	return 0;
+}
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""
+Minimal NoSec LwM2M server stand-in that accepts Register, Update and
+De-register, observes the given resources and groups the traffic into radio
+sessions, i.e. bursts of datagrams separated by more than --session-gap seconds
+of silence. It is meant to check the effect of CONFIG_APP_QUEUE_BATCHING of the
+demo on native_sim, not to be a compliant server.
+"""
+import argparse
+import itertools
+import os
+import socket
+import struct
+import sys
+import time
+
+COAP_VERSION = 1
+TYPE_CON, TYPE_NON, TYPE_ACK, TYPE_RST = range(4)
+
+CODE_EMPTY = 0x00
+CODE_GET = 0x01
+CODE_POST = 0x02
+CODE_DELETE = 0x04
+CODE_CREATED = 0x41
+CODE_DELETED = 0x42
+CODE_CHANGED = 0x44
+CODE_NOT_FOUND = 0x84
+
+OPTION_OBSERVE = 6
+OPTION_LOCATION_PATH = 8
+OPTION_URI_PATH = 11
+OPTION_URI_QUERY = 15
+
+PAYLOAD_MARKER = 0xFF
+
+
+class Message:
+    def __init__(self, type, code, message_id, token=b'', options=(), payload=b''):
+        self.type = type
+        self.code = code
+        self.message_id = message_id
+        self.token = token
+        self.options = list(options)
+        self.payload = payload
+
+    def option_values(self, number):
+        return [value for option, value in self.options if option == number]
+
+    def uri_path(self):
+        return [value.decode(errors='replace') for value in self.option_values(OPTION_URI_PATH)]
+
+    @staticmethod
+    def _read_extended(data, pos, value):
+        if value == 13:
+            return data[pos] + 13, pos + 1
+        if value == 14:
+            return struct.unpack_from('>H', data, pos)[0] + 269, pos + 2
+        if value == 15:
+            raise ValueError('reserved option nibble')
+        return value, pos
+
+    @classmethod
+    def parse(cls, data):
+        if len(data) < 4 or data[0] >> 6 != COAP_VERSION:
+            raise ValueError('not a CoAP message')
+        token_len = data[0] & 0x0F
+        message_id = struct.unpack_from('>H', data, 2)[0]
+        pos = 4 + token_len
+        msg = cls((data[0] >> 4) & 0x03, data[1], message_id, bytes(data[4:pos]))
+        number = 0
+        while pos < len(data) and data[pos] != PAYLOAD_MARKER:
+            delta, length = data[pos] >> 4, data[pos] & 0x0F
+            delta, pos = cls._read_extended(data, pos + 1, delta)
+            length, pos = cls._read_extended(data, pos, length)
+            number += delta
+            msg.options.append((number, bytes(data[pos:pos + length])))
+            pos += length
+        if pos < len(data):
+            msg.payload = bytes(data[pos + 1:])
+        return msg
+
+    @staticmethod
+    def _nibble(value):
+        if value < 13:
+            return value, b''
+        if value < 269:
+            return 13, bytes([value - 13])
+        return 14, struct.pack('>H', value - 269)
+
+    def serialize(self):
+        data = bytearray([COAP_VERSION << 6 | self.type << 4 | len(self.token), self.code])
+        data += struct.pack('>H', self.message_id) + self.token
+        number = 0
+        for option, value in sorted(self.options, key=lambda option: option[0]):
+            delta, delta_ext = self._nibble(option - number)
+            length, length_ext = self._nibble(len(value))
+            data += bytes([delta << 4 | length]) + delta_ext + length_ext + value
+            number = option
+        if self.payload:
+            data += bytes([PAYLOAD_MARKER]) + self.payload
+        return bytes(data)
+
+
+class SessionServer:
+    def __init__(self, args):
+        self.args = args
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind((args.address, args.port))
+        self.message_ids = itertools.count(int.from_bytes(os.urandom(2), 'big'))
+        self.registrations = itertools.count(1)
+        self.observations = {}
+        # tokens of the Observe requests, by message ID, as a Reset carries no token
+        self.observe_requests = {}
+        self.last_datagram = None
+        self.sessions = []
+        # of the datagram being handled
+        self.size = 0
+
+    def _account(self, direction, kind, size):
+        now = time.monotonic()
+        if self.last_datagram is None or now - self.last_datagram > self.args.session_gap:
+            self.sessions.append([])
+            print('--- radio session %d' % len(self.sessions))
+        self.last_datagram = now
+        self.sessions[-1].append((direction, kind))
+        print('%s %-4s %-24s %4d B' % (time.strftime('%H:%M:%S'), direction, kind, size))
+
+    def _send(self, msg, addr, kind):
+        data = msg.serialize()
+        self._account('->', kind, len(data))
+        self.sock.sendto(data, addr)
+
+    def _respond(self, request, addr, code, kind, options=()):
+        type = TYPE_ACK if request.type == TYPE_CON else TYPE_NON
+        message_id = request.message_id if type == TYPE_ACK else next(self.message_ids) & 0xFFFF
+        self._send(Message(type, code, message_id, request.token, options), addr, kind)
+
+    def _observe(self, addr):
+        for path in self.args.observe:
+            token = os.urandom(4)
+            message_id = next(self.message_ids) & 0xFFFF
+            self.observations[token] = path
+            self.observe_requests[message_id] = token
+            options = [(OPTION_OBSERVE, b'')]
+            options += [(OPTION_URI_PATH, segment.encode())
+                        for segment in path.strip('/').split('/')]
+            self._send(Message(TYPE_CON, CODE_GET, message_id, token, options), addr,
+                       'Observe ' + path)
+
+    def _handle_request(self, msg, addr):
+        path = msg.uri_path()
+        if path == ['dp'] and msg.code == CODE_POST:
+            self._account('<-', 'Send', self.size)
+            self._respond(msg, addr, CODE_CHANGED, 'Changed')
+            return
+        if path[:1] != ['rd']:
+            self._account('<-', 'request /' + '/'.join(path), self.size)
+            self._respond(msg, addr, CODE_NOT_FOUND, 'Not Found')
+            return
+
+        if msg.code == CODE_POST and len(path) == 1:
+            query = b'&'.join(msg.option_values(OPTION_URI_QUERY)).decode(errors='replace')
+            self._account('<-', 'Register', self.size)
+            print('    %s' % query)
+            location = [(OPTION_LOCATION_PATH, b'rd'),
+                        (OPTION_LOCATION_PATH, str(next(self.registrations)).encode())]
+            self._respond(msg, addr, CODE_CREATED, 'Created', location)
+            self._observe(addr)
+        elif msg.code == CODE_POST:
+            self._account('<-', 'Update', self.size)
+            self._respond(msg, addr, CODE_CHANGED, 'Changed')
+        elif msg.code == CODE_DELETE:
+            self._account('<-', 'De-register', self.size)
+            self._respond(msg, addr, CODE_DELETED, 'Deleted')
+            self.observations.clear()
+            self.observe_requests.clear()
+
+    def _handle_response(self, msg, addr):
+        path = self.observations.get(msg.token)
+        if path is None:
+            self._account('<-', 'unknown response', self.size)
+            if msg.type == TYPE_CON:
+                self._send(Message(TYPE_RST, CODE_EMPTY, msg.message_id), addr, 'Reset')
+            return
+
+        notification = msg.type != TYPE_ACK
+        self._account('<-', ('Notify ' if notification else 'Observed ') + path, self.size)
+        if msg.type == TYPE_CON:
+            self._send(Message(TYPE_ACK, CODE_EMPTY, msg.message_id), addr, 'ACK')
+
+    def summary(self):
+        print('\n%d radio sessions' % len(self.sessions))
+        for index, session in enumerate(self.sessions, 1):
+            uplinks = [kind for direction, kind in session if direction == '<-']
+            print('  %3d: %d datagrams, uplink: %s' % (index, len(session), ', '.join(uplinks)))
+
+    def run(self):
+        print('Listening on %s:%d' % (self.args.address, self.args.port))
+        while True:
+            data, addr = self.sock.recvfrom(4096)
+            self.size = len(data)
+            try:
+                msg = Message.parse(data)
+            except (ValueError, IndexError, struct.error):
+                self._account('<-', 'not CoAP', self.size)
+                continue
+
+            if msg.code == CODE_EMPTY:
+                self._account('<-', 'Reset' if msg.type == TYPE_RST else 'ACK', self.size)
+                if msg.type == TYPE_RST:
+                    token = self.observe_requests.pop(msg.message_id, None)
+                    self.observations.pop(token, None)
+            elif msg.code >> 5 == 0:
+                self._handle_request(msg, addr)
+            else:
+                self._handle_response(msg, addr)
+
+
+def _main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-a', '--address', default='0.0.0.0', help='address to listen on')
+    parser.add_argument('-p', '--port', type=int, default=5683, help='UDP port to listen on')
+    parser.add_argument('-o', '--observe', action='append', default=[],
+                        help='path to observe after each Register, e.g. /3303/0/5700; '
+                             'may be given multiple times')
+    parser.add_argument('-g', '--session-gap', type=float, default=10.0,
+                        help='seconds of silence that end a radio session, should match the '
+                             'queue mode timeout of the client (default: %(default)s)')
+    args = parser.parse_args()
+
+    server = SessionServer(args)
+    try:
+        server.run()
+    except KeyboardInterrupt:
+        server.summary()
+
+
+if __name__ == '__main__':
+    sys.exit(_main())
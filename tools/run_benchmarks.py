@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""
+Builds the demo for native_sim in the benchmark mode (overlay_benchmark.conf)
+in several variants, runs each of them and prints the figures of their
+reports side by side. Must be run in a west workspace of the demo.
+
+The "Wall-clock time per cycle" maximum is the worst-case time the Anjay thread
+spent in a single wakeup of the object update loop, including the time it was
+blocked, i.e. how long the sensor I/O done on that thread may delay CoAP
+retransmissions and DTLS handling. The emulated sensors never block, so use
+--i2c-latency-us and --i2c-nack-every to model a slow or failing bus. The "CPU
+time per cycle" is measured on the host, so only compare variants run on the
+same machine.
+
+The "CPU time per sensor hub batch" compares serial fetching of the sensors on
+the hub thread with the RTIO batches (sensor-hub vs. sensor-hub-rtio).
+"""
+import argparse
+import collections
+import os
+import re
+import subprocess
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+Variant = collections.namedtuple('Variant', ['description', 'cmake_args'])
+
+VARIANTS = collections.OrderedDict([
+    ('direct', Variant('sensor I/O on the Anjay thread', [])),
+    ('sensor-hub', Variant('sensor I/O on the sensor hub thread',
+                           ['-DCONFIG_APP_SENSOR_HUB=y'])),
+    ('sensor-hub-rtio', Variant('sensor hub reading the devices in RTIO batches',
+                                ['-DCONFIG_APP_SENSOR_HUB=y', '-DCONFIG_APP_SENSOR_RTIO=y'])),
+])
+
+# lines of the report of benchmark.c that are compared
+REPORT_LINE = re.compile(
+    r'((?:CPU|Wall-clock) time per .*|Emulated I2C: .*|Benchmark finished .*)$')
+
+
+def _build(name, variant, args):
+    build_dir = os.path.join(args.build_root, name)
+    command = ['west', 'build', '-p', 'auto', '-b', 'native_sim', '-d', build_dir,
+               os.path.join(REPO_ROOT, 'demo'), '--',
+               '-DEXTRA_CONF_FILE=overlay_benchmark.conf',
+               '-DCONFIG_APP_BENCHMARK_I2C_LATENCY_US=%d' % (args.i2c_latency_us,),
+               '-DCONFIG_APP_BENCHMARK_I2C_NACK_EVERY=%d' % (args.i2c_nack_every,)
+               ] + variant.cmake_args
+    print('$ ' + ' '.join(command), flush=True)
+    subprocess.run(command, check=True,
+                   stdout=None if args.verbose else subprocess.DEVNULL)
+    return build_dir
+
+
+def _run(build_dir, args):
+    # the executable exits by itself after the report
+    result = subprocess.run([os.path.join(build_dir, 'zephyr', 'zephyr.exe'), '--no-rt'],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            timeout=args.timeout)
+    return result.stdout.decode(errors='replace')
+
+
+def _report_lines(output):
+    lines = []
+    for line in output.splitlines():
+        match = REPORT_LINE.search(line)
+        if match:
+            lines.append(match.group(1))
+    return lines
+
+
+def _main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('variants', nargs='*', metavar='variant',
+                        help='variants to run (default: all): ' + ', '.join(VARIANTS))
+    parser.add_argument('--build-root', default='build-benchmarks',
+                        help='directory for the build directories of the variants')
+    parser.add_argument('--timeout', type=float, default=600.0,
+                        help='maximum run time of a single variant [s]')
+    parser.add_argument('--i2c-latency-us', type=int, default=0,
+                        help='latency injected into every emulated I2C transfer [us]')
+    parser.add_argument('--i2c-nack-every', type=int, default=0, metavar='N',
+                        help='fail every N-th emulated I2C transfer as not acknowledged')
+    parser.add_argument('-v', '--verbose', action='store_true', help='show the build output')
+    args = parser.parse_args()
+
+    unknown = [name for name in args.variants if name not in VARIANTS]
+    if unknown:
+        parser.error('unknown variants: ' + ', '.join(unknown))
+
+    results = collections.OrderedDict()
+    for name in args.variants or VARIANTS:
+        variant = VARIANTS[name]
+        try:
+            build_dir = _build(name, variant, args)
+            results[name] = _report_lines(_run(build_dir, args))
+        except (subprocess.CalledProcessError, subprocess.TimeoutExpired) as e:
+            results[name] = ['failed: %s' % (e,)]
+
+    for name, lines in results.items():
+        print('\n%s (%s):' % (name, VARIANTS[name].description))
+        for line in lines or ['no report found']:
+            print('    ' + line)
+
+
+if __name__ == '__main__':
+    _main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright 2020-2025 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""
+Compares the text and dictionary logging profiles (overlay_log_dictionary.conf)
+on qemu_x86. Must be run in a west workspace of the minimal client.
+
+For each profile, builds:
+- the minimal client without the shell, and reports the flash used by the
+  image (text and data sections, as reported by the size tool),
+- tools/log_benchmark, runs it in QEMU, decodes its output if needed and
+  reports the cost of a log call in cycles: deferred, i.e. at the call site
+  only, and synchronous, i.e. including formatting and output by the backend.
+
+The benchmark does not use networking, so QEMU runs it with instruction
+counting (CONFIG_QEMU_ICOUNT) and the number of cycles does not depend on the
+load of the host.
+"""
+import argparse
+import collections
+import os
+import re
+import select
+import signal
+import subprocess
+import sys
+import time
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TOOLS_DIR = os.path.join(REPO_ROOT, 'tools')
+DICTIONARY_OVERLAY = os.path.join(REPO_ROOT, 'minimal', 'overlay_log_dictionary.conf')
+
+Profile = collections.namedtuple('Profile', ['description', 'cmake_args', 'dictionary'])
+
+PROFILES = collections.OrderedDict([
+    ('text', Profile('text logging', ['-DCONFIG_SHELL=n'], False)),
+    ('dictionary', Profile('dictionary logging',
+                           ['-DEXTRA_CONF_FILE=' + DICTIONARY_OVERLAY], True)),
+])
+
+# lines of the report of tools/log_benchmark that are compared
+REPORT_LINE = re.compile(r'(Log call \(.*|Log benchmark finished.*)$')
+
+
+def _build(app, build_dir, profile, args):
+    command = ['west', 'build', '-p', 'auto', '-b', 'qemu_x86', '-d', build_dir, app,
+               '--'] + profile.cmake_args
+    print('$ ' + ' '.join(command), flush=True)
+    subprocess.run(command, check=True,
+                   stdout=None if args.verbose else subprocess.DEVNULL)
+
+
+def _flash_size(build_dir, args):
+    output = subprocess.run([args.size_tool, os.path.join(build_dir, 'zephyr', 'zephyr.elf')],
+                            check=True, stdout=subprocess.PIPE).stdout.decode()
+    # the second line is: text data bss dec hex filename
+    text, data = output.splitlines()[1].split()[:2]
+    return int(text) + int(data)
+
+
+def _run_qemu(build_dir, args):
+    # QEMU does not exit by itself, so it is stopped once the output is idle
+    process = subprocess.Popen(['west', 'build', '-d', build_dir, '-t', 'run'],
+                               stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT, start_new_session=True)
+    output = b''
+    deadline = time.monotonic() + args.timeout
+    try:
+        while time.monotonic() < deadline:
+            ready, _, _ = select.select([process.stdout], [], [], args.idle)
+            if not ready:
+                break
+            data = os.read(process.stdout.fileno(), 4096)
+            if not data:
+                break
+            output += data
+    finally:
+        os.killpg(process.pid, signal.SIGTERM)
+        process.wait()
+    return output
+
+
+def _decode(build_dir, output):
+    capture = os.path.join(build_dir, 'capture.txt')
+    with open(capture, 'wb') as f:
+        f.write(output)
+    # the decoder prints the messages through logging, i.e. to stderr
+    result = subprocess.run([sys.executable, os.path.join(TOOLS_DIR, 'decode_log_dictionary.py'),
+                             os.path.join(build_dir, 'zephyr', 'log_dictionary.json'), capture],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    return result.stdout
+
+
+def _report_lines(output):
+    lines = []
+    for line in output.decode(errors='replace').splitlines():
+        match = REPORT_LINE.search(line)
+        if match:
+            lines.append(match.group(1))
+    return lines
+
+
+def _measure(name, profile, args):
+    lines = []
+    build_dir = os.path.join(args.build_root, 'minimal-' + name)
+    _build(os.path.join(REPO_ROOT, 'minimal'), build_dir, profile, args)
+    lines.append('Minimal client flash: %d B' % (_flash_size(build_dir, args),))
+
+    build_dir = os.path.join(args.build_root, 'log_benchmark-' + name)
+    _build(os.path.join(TOOLS_DIR, 'log_benchmark'), build_dir, profile, args)
+    output = _run_qemu(build_dir, args)
+    if profile.dictionary:
+        output = _decode(build_dir, output)
+    return lines + (_report_lines(output) or ['no report found'])
+
+
+def _main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('profiles', nargs='*', metavar='profile',
+                        help='profiles to compare (default: all): ' + ', '.join(PROFILES))
+    parser.add_argument('--build-root', default='build-log-benchmarks',
+                        help='directory for the build directories of the profiles')
+    parser.add_argument('--size-tool', default='size',
+                        help='size tool of the toolchain (default: size)')
+    parser.add_argument('--timeout', type=float, default=300.0,
+                        help='maximum run time of the benchmark in QEMU [s]')
+    parser.add_argument('--idle', type=float, default=10.0,
+                        help='time without output after which QEMU is stopped [s]')
+    parser.add_argument('-v', '--verbose', action='store_true', help='show the build output')
+    args = parser.parse_args()
+
+    unknown = [name for name in args.profiles if name not in PROFILES]
+    if unknown:
+        parser.error('unknown profiles: ' + ', '.join(unknown))
+
+    results = collections.OrderedDict()
+    for name in args.profiles or PROFILES:
+        try:
+            results[name] = _measure(name, PROFILES[name], args)
+        except (subprocess.CalledProcessError, OSError) as e:
+            results[name] = ['failed: %s' % (e,)]
+
+    for name, lines in results.items():
+        print('\n%s (%s):' % (name, PROFILES[name].description))
+        for line in lines:
+            print('    ' + line)
+
+
+if __name__ == '__main__':
+    _main()